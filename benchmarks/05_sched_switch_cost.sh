@@ -0,0 +1,76 @@
+#!/bin/bash
+# ==========================================
+# 05_sched_switch_cost.sh
+# Purpose: Measure the in-kernel cost of handle_sched_switch per event
+# Compares a baseline build (shared hash + atomics) against the current
+# build (per-CPU maps) under the same context-switch storm.
+# ==========================================
+
+# --- Configuration ---
+DURATION=20
+DOCKER_IMAGE="alexeiled/stress-ng:latest"
+
+# WORKLOAD: context-switch heavy, one pipe-pair stressor per core
+STRESS_ARGS="--switch 0 --timeout ${DURATION}s"
+
+# Build the baseline from the commit before the per-CPU change, e.g.
+#   git worktree add /tmp/baseline <commit> && (cd /tmp/baseline && make generate build-arm64)
+BASELINE_BIN="./ebpf_edge_arm64_baseline"
+AGENT_BIN="./ebpf_edge_arm64_p"
+
+# Kernel exposes run_time_ns / run_cnt per program only while stats are on.
+echo ">>> Enabling BPF runtime statistics..."
+sudo sysctl -q -w kernel.bpf_stats_enabled=1
+
+# measure <binary> <label>
+# Starts cpuwatch, drives the switch storm, and prints ns per event.
+measure() {
+    local bin=$1
+    local label=$2
+
+    sudo pkill -f "$bin" 2>/dev/null
+    sleep 1
+
+    sudo $bin cpuwatch > /dev/null 2>&1 &
+    local pid=$!
+    sleep 3
+
+    if ! ps -p $pid > /dev/null; then
+        echo "CRITICAL ERROR: $label agent died immediately."
+        return 1
+    fi
+
+    docker run --rm --name rq_switch_cost $DOCKER_IMAGE $STRESS_ARGS \
+        --metrics-brief --quiet > /dev/null 2>&1
+
+    # bpftool truncates program names to 15 chars (handle_sched_sw).
+    local line
+    line=$(sudo bpftool prog show | grep -A2 "name handle_sched_sw" | tr '\n' ' ')
+    local run_ns run_cnt
+    run_ns=$(echo "$line" | awk '{for (i=1;i<NF;i++) if ($i=="run_time_ns") print $(i+1)}')
+    run_cnt=$(echo "$line" | awk '{for (i=1;i<NF;i++) if ($i=="run_cnt") print $(i+1)}')
+
+    sudo kill $pid
+    wait $pid 2>/dev/null
+
+    if [ -z "$run_cnt" ] || [ "$run_cnt" -eq 0 ]; then
+        echo "   $label: no samples (is bpftool installed?)"
+        return 1
+    fi
+
+    local per_event
+    per_event=$(awk "BEGIN {printf \"%.1f\", $run_ns / $run_cnt}")
+    printf "%-10s | %-14s | %-10s\n" "$label" "$run_cnt" "$per_event"
+}
+
+echo ""
+echo "========================================================"
+echo " SCHED_SWITCH COST (${DURATION}s switch storm)"
+echo "========================================================"
+printf "%-10s | %-14s | %-10s\n" "Build" "Events" "ns/event"
+echo "----------------------------------------"
+measure "$BASELINE_BIN" "baseline"
+measure "$AGENT_BIN" "per-cpu"
+echo "========================================================"
+
+sudo sysctl -q -w kernel.bpf_stats_enabled=0
@@ -0,0 +1,63 @@
+#!/bin/bash
+# ==========================================
+# 06_short_lived_churn.sh
+# Purpose: Check that CPU burned by short-lived processes is accounted
+# Spawns thousands of ~50ms busy processes and compares the CPU time the
+# agent attributed (live PIDs + exited PIDs drained after exit) with the
+# CPU time the kernel charged to the processes themselves.
+# ==========================================
+
+# --- Configuration ---
+PROCS=4000        # Number of short-lived processes
+BURN="0.05"       # Seconds each process spins before being killed
+PARALLEL=$(nproc) # Processes running at once
+AGENT_BIN="./ebpf_edge_arm64_p"
+LOG=/tmp/churn_agent.log
+
+sudo pkill -f "$AGENT_BIN" 2>/dev/null
+sleep 1
+
+# The detail view logs one "accounted:" line per poll.
+sudo $AGENT_BIN cpuwatch -v --cpu-per-pid 2> $LOG > /dev/null &
+AGENT_PID=$!
+sleep 3
+
+if ! ps -p $AGENT_PID > /dev/null; then
+    echo "CRITICAL ERROR: Agent died immediately."
+    exit 1
+fi
+
+# Skip the polls logged before the workload started.
+START_LINE=$(wc -l < $LOG)
+
+echo ">>> Spawning $PROCS processes of ${BURN}s, $PARALLEL at a time..."
+# GNU time reports the user+sys time of the driver and every reaped child.
+ACTUAL=$( { /usr/bin/time -f "%U %S" bash -c \
+    "seq $PROCS | xargs -P $PARALLEL -I{} timeout $BURN sh -c 'while :; do :; done'" ; } 2>&1 | tail -n1)
+
+# Two more polls so the last exits are drained.
+sleep 3
+sudo kill $AGENT_PID
+wait $AGENT_PID 2>/dev/null
+
+actual_ms=$(echo "$ACTUAL" | awk '{printf "%.0f", ($1 + $2) * 1000}')
+
+# accounted: live X ms + exited Y ms (N PIDs) of Z ms busy
+read live_ms exited_ms exited_pids busy_ms < <(tail -n +$((START_LINE + 1)) $LOG | \
+    awk '/accounted:/ {live += $4; exited += $8; pids += substr($10, 2); busy += $13}
+         END {printf "%.0f %.0f %d %.0f\n", live, exited, pids, busy}')
+
+echo ""
+echo "========================================================"
+echo " SHORT-LIVED PROCESS ACCOUNTING ($PROCS x ${BURN}s)"
+echo "========================================================"
+printf "%-32s | %10s\n" "Source" "CPU (ms)"
+echo "----------------------------------------------"
+printf "%-32s | %10s\n" "Actual (workload rusage)" "$actual_ms"
+printf "%-32s | %10s\n" "Node busy (cpu_busy)" "$busy_ms"
+printf "%-32s | %10s\n" "Per-PID: live" "$live_ms"
+printf "%-32s | %10s\n" "Per-PID: exited ($exited_pids PIDs)" "$exited_ms"
+printf "%-32s | %10s\n" "Per-PID: total" "$((live_ms + exited_ms))"
+echo "========================================================"
+echo "Node busy and the per-PID total also include background activity,"
+echo "so both should be at or slightly above the actual figure."
@@ -0,0 +1,88 @@
+#!/bin/bash
+# ==========================================
+# 07_gossip_conn_pool.sh
+# Purpose: Measure the cost of metric pushes with and without the connection pool
+# Runs the peer twice against the same remote peers with unary Push
+# (--gossip-push): once over the pooled connections, once with
+# --dial-per-push (dial + close on every push).
+# Reports per-push latency, agent CPU time and TIME_WAIT sockets for each mode.
+# ==========================================
+
+# --- Configuration ---
+DURATION=120 # Seconds per mode (40 pushes per peer at the 3s gossip period)
+
+# !!! UPDATE THIS IP TO MATCH YOUR SETUP !!!
+PEER_IPS="192.168.0.250,192.168.0.x"
+
+AGENT_BIN="./ebpf_edge_arm64_p"
+PEER_PORT=60000
+TICKS=$(getconf CLK_TCK)
+
+run_mode() {
+    local label=$1
+    shift
+    local log=/tmp/gossip_${label}.log
+
+    sudo pkill -f "$AGENT_BIN" 2>/dev/null
+    sleep 2
+
+    # -v logs one "[GOSSIP] push" line per push on stderr; stdout is the cluster view.
+    sudo $AGENT_BIN peer -v --peers=$PEER_IPS "$@" 2> $log > /dev/null &
+    sleep 3
+
+    local pid
+    pid=$(pgrep -n -f "$AGENT_BIN peer")
+    if [ -z "$pid" ]; then
+        echo "CRITICAL ERROR: Agent died immediately. Check your IP configuration."
+        exit 1
+    fi
+
+    # Skip the pushes logged while the agent was starting.
+    local start_line
+    start_line=$(wc -l < $log)
+    local cpu_start
+    cpu_start=$(sudo awk '{print $14 + $15}' /proc/$pid/stat)
+
+    local tw_max=0
+    for _ in $(seq 1 $DURATION); do
+        tw=$(ss -tan state time-wait "( dport = :$PEER_PORT )" | tail -n +2 | wc -l)
+        [ "$tw" -gt "$tw_max" ] && tw_max=$tw
+        sleep 1
+    done
+
+    local cpu_end
+    cpu_end=$(sudo awk '{print $14 + $15}' /proc/$pid/stat)
+    sudo kill $pid
+    sleep 1
+
+    # [GOSSIP] push <ip>: <ms> ms (err: <nil>)
+    local pushes_log=/tmp/gossip_${label}.pushes
+    tail -n +$((start_line + 1)) $log | grep "\[GOSSIP\] push" > $pushes_log
+    local failed
+    failed=$(grep -vc "(err: <nil>)" $pushes_log)
+    read pushes avg p99 < <(grep "(err: <nil>)" $pushes_log | awk '{print $4}' | sort -n | \
+        awk '{ v[NR] = $1; sum += $1 }
+             END { if (NR == 0) { print 0, 0, 0; exit }
+                   i = int(NR * 0.99); if (i < 1) i = 1
+                   printf "%d %.3f %.3f\n", NR, sum / NR, v[i] }')
+
+    local cpu_ms
+    cpu_ms=$(awk "BEGIN {printf \"%.0f\", ($cpu_end - $cpu_start) * 1000 / $TICKS}")
+
+    printf "%-14s | %7s | %9s | %9s | %7s | %12s | %9s\n" \
+        "$label" "$pushes" "$avg" "$p99" "$failed" "$cpu_ms" "$tw_max"
+}
+
+echo ">>> Measuring each mode for ${DURATION}s against: $PEER_IPS"
+echo ""
+echo "========================================================================================"
+echo " GOSSIP PUSH COST (${DURATION}s per mode)"
+echo "========================================================================================"
+printf "%-14s | %7s | %9s | %9s | %7s | %12s | %9s\n" \
+    "Mode" "Pushes" "Avg (ms)" "p99 (ms)" "Failed" "Agent CPU ms" "TIME_WAIT"
+echo "----------------------------------------------------------------------------------------"
+run_mode "dial-per-push" --dial-per-push
+run_mode "pooled" --gossip-push
+echo "========================================================================================"
+echo "Agent CPU includes the collectors, which run identically in both modes:"
+echo "the difference between the rows is the cost of the pushes."
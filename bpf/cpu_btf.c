@@ -0,0 +1,415 @@
+// go:build ignore
+#include <linux/bpf.h>
+#include "../bpf/headers/bpf_helpers.h"
+
+typedef unsigned char u8;
+typedef unsigned int u32;
+typedef unsigned long long u64;
+
+/* * CO-RE TASK LAYOUT (All boards: Raspberry Pi 5 / Jetson Orin / Generic AMD64)
+ * Only the fields we read are declared. preserve_access_index makes clang emit
+ * BTF relocations, so the loader patches in the real offsets from the running
+ * kernel's BTF (/sys/kernel/btf/vmlinux) instead of us hardcoding them per vendor.
+ */
+typedef struct
+{
+    int counter;
+} atomic_t;
+
+struct signal_struct
+{
+    atomic_t live; // Threads of the group that have not exited yet
+} __attribute__((preserve_access_index));
+
+struct task_struct
+{
+    int pid;  // Thread ID
+    int tgid; // Process ID
+    struct signal_struct *signal;
+} __attribute__((preserve_access_index));
+
+/* * MAP: start_times
+ * Tracks when the task currently on this CPU was switched in.
+ * A task is switched in and out on the same CPU, so one slot per CPU is enough
+ * and the hot path never touches a cache line owned by another core.
+ * Busy time is only charged at switch-out, so userspace also reads the open
+ * slice from here: a core pegged by one task that never yields must not read idle.
+ * Key: 0, Value: struct slice, one copy per CPU
+ */
+struct slice
+{
+    u64 start_ns; // bpf_ktime_get_ns() at switch-in (0 = not seen yet)
+    u64 busy;     // Nonzero while a non-idle task holds the CPU
+};
+
+struct
+{
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __type(key, u32);
+    __type(value, struct slice);
+    __uint(max_entries, 1);
+} start_times SEC(".maps");
+
+/* * MAP: cpu_usage
+ * Accumulates total CPU time used by a process (all of its threads).
+ * Each CPU owns its own copy of the counter, so updates are plain adds
+ * instead of cross-core atomics. Userspace sums the per-CPU values on read.
+ * Keyed by TGID, the same id the exit hook sees, so every entry has an owner
+ * that eventually frees it. LRU as a backstop: if cleanup is ever missed, the
+ * coldest process is evicted instead of new updates failing once it is full.
+ * Key: TGID (u32), Value: Total duration in ns (u64), one copy per CPU
+ */
+struct
+{
+    __uint(type, BPF_MAP_TYPE_LRU_PERCPU_HASH);
+    __type(key, u32);
+    __type(value, u64);
+    __uint(max_entries, 10240);
+} cpu_usage SEC(".maps");
+
+/* * MAP: cpu_busy
+ * Node-level headline counter: total non-idle time in ns.
+ * One slot per CPU, so userspace derives node CPU% from a single lookup
+ * instead of walking every PID in cpu_usage.
+ * Key: 0, Value: Busy duration in ns (u64), one copy per CPU
+ */
+struct
+{
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __type(key, u32);
+    __type(value, u64);
+    __uint(max_entries, 1);
+} cpu_busy SEC(".maps");
+
+/* * FREQUENCY SCALING
+ * 50% busy at 600 MHz is not the capacity of 50% busy at 2.4 GHz. Each busy
+ * slice is also weighted by the clock its CPU ran at, so userspace can scale
+ * utilization by freq/max_freq without sampling frequencies itself.
+ */
+#define MAX_CPUS 256
+
+/* * MAP: cpu_freq
+ * Current clock of each CPU, from power/cpu_frequency. The event can fire on
+ * a different CPU than the one it describes, so this is a plain array indexed
+ * by CPU id. Userspace seeds it from sysfs: the event only reports changes.
+ * Key: CPU id (u32), Value: Frequency in MHz (u32)
+ */
+struct
+{
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __type(key, u32);
+    __type(value, u32);
+    __uint(max_entries, MAX_CPUS);
+} cpu_freq SEC(".maps");
+
+/* * MAP: cpu_busy_mhz
+ * Like cpu_busy, but each slice is multiplied by the CPU's clock in MHz.
+ * Only differences are meaningful; wrapping is harmless for them.
+ * Key: 0, Value: Busy ns x MHz (u64), one copy per CPU
+ */
+struct
+{
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __type(key, u32);
+    __type(value, u64);
+    __uint(max_entries, 1);
+} cpu_busy_mhz SEC(".maps");
+
+/* * MAP: map_errors
+ * Updates the programs could not make. Non-zero values mean the numbers
+ * userspace derives are incomplete, so the poller reports them.
+ * Key: 0, Value: struct map_errors, one copy per CPU
+ */
+struct map_errors
+{
+    u64 usage_update;  // cpu_usage insert failed
+    u64 cgroup_update; // cgroup_usage insert failed
+    u64 wakeup_update; // wakeup_ts insert failed
+    u64 exit_dropped;  // exited_pids full; entry deleted without a final drain
+};
+
+struct
+{
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __type(key, u32);
+    __type(value, struct map_errors);
+    __uint(max_entries, 1);
+} map_errors SEC(".maps");
+
+static __always_inline struct map_errors *errors(void)
+{
+    u32 zero = 0;
+    return bpf_map_lookup_elem(&map_errors, &zero);
+}
+
+/* * MAP: exited_pids
+ * TGIDs whose process has exited. Their cpu_usage entry is NOT deleted here:
+ * the per-CPU copies can only be summed from userspace, so the poller reads
+ * the final runtime, folds it into its "retired" total and deletes the entry.
+ * Value: TGID (u32)
+ */
+struct
+{
+    __uint(type, BPF_MAP_TYPE_RINGBUF);
+    __uint(max_entries, 16384);
+} exited_pids SEC(".maps");
+
+/* * MAP: cgroup_usage
+ * Accumulates CPU time per cgroup (v2 id), so userspace can attribute runtime
+ * to the container a job ran in without asking the Docker stats API.
+ * LRU so cgroups of finished containers age out on their own.
+ * Key: cgroup id (u64), Value: Total duration in ns (u64), one copy per CPU
+ */
+struct
+{
+    __uint(type, BPF_MAP_TYPE_LRU_PERCPU_HASH);
+    __type(key, u64);
+    __type(value, u64);
+    __uint(max_entries, 1024);
+} cgroup_usage SEC(".maps");
+
+/* * RUN-QUEUE LATENCY
+ * Wakeup-to-run delay: how long a task that became runnable waited for a CPU.
+ * Aggregated in-kernel into a log2 histogram of microseconds, so userspace reads
+ * one value per poll no matter how many wakeups happened.
+ * Slot i counts delays in [2^i, 2^(i+1)) us; slot 0 also holds delays under 1 us.
+ */
+#define RUNQ_SLOTS 32
+
+struct runq_hist
+{
+    u64 slots[RUNQ_SLOTS];
+};
+
+/* * MAP: wakeup_ts
+ * When each woken task became runnable. LRU so wakeups whose switch-in we
+ * never see (agent start/stop, lost tasks) cannot fill the map.
+ * Key: TID (u32), Value: Timestamp in ns (u64)
+ */
+struct
+{
+    __uint(type, BPF_MAP_TYPE_LRU_HASH);
+    __type(key, u32);
+    __type(value, u64);
+    __uint(max_entries, 10240);
+} wakeup_ts SEC(".maps");
+
+/* * MAP: runq_latency
+ * Cumulative histogram, one copy per CPU. Userspace sums and differences it.
+ * Key: 0, Value: struct runq_hist, one copy per CPU
+ */
+struct
+{
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __type(key, u32);
+    __type(value, struct runq_hist);
+    __uint(max_entries, 1);
+} runq_latency SEC(".maps");
+
+// Branch-free integer log2 (the verifier rejects unbounded loops).
+static __always_inline u32 log2_u32(u32 v)
+{
+    u32 r, shift;
+
+    r = (v > 0xFFFF) << 4;
+    v >>= r;
+    shift = (v > 0xFF) << 3;
+    v >>= shift;
+    r |= shift;
+    shift = (v > 0xF) << 2;
+    v >>= shift;
+    r |= shift;
+    shift = (v > 0x3) << 1;
+    v >>= shift;
+    r |= shift;
+    r |= (v >> 1);
+    return r;
+}
+
+static __always_inline u32 log2_u64(u64 v)
+{
+    u32 hi = v >> 32;
+    if (hi)
+        return log2_u32(hi) + 32;
+    return log2_u32((u32)v);
+}
+
+static __always_inline int record_wakeup(struct task_struct *p)
+{
+    u32 pid = p->pid;
+    if (pid == 0)
+        return 0;
+    u64 now = bpf_ktime_get_ns();
+    if (bpf_map_update_elem(&wakeup_ts, &pid, &now, BPF_ANY))
+    {
+        struct map_errors *err = errors();
+        if (err)
+            err->wakeup_update += 1;
+    }
+    return 0;
+}
+
+/*
+ * HOOK: tp_btf/sched_wakeup, tp_btf/sched_wakeup_new
+ * A sleeping (or newly forked) task became runnable: start its queue clock.
+ * ctx[0] = the woken task.
+ */
+SEC("tp_btf/sched_wakeup")
+int handle_sched_wakeup(u64 *ctx)
+{
+    return record_wakeup((struct task_struct *)ctx[0]);
+}
+
+SEC("tp_btf/sched_wakeup_new")
+int handle_sched_wakeup_new(u64 *ctx)
+{
+    return record_wakeup((struct task_struct *)ctx[0]);
+}
+
+/*
+ * HOOK: tp_btf/sched_switch
+ * Triggered every time the OS scheduler switches tasks.
+ * Raw BTF tracepoint: arguments arrive as the kernel's own typed pointers
+ * (ctx[0] = preempt, ctx[1] = prev, ctx[2] = next) without the classic
+ * tracepoint's record formatting, which also makes each event cheaper.
+ */
+SEC("tp_btf/sched_switch")
+int handle_sched_switch(u64 *ctx)
+{
+    struct task_struct *prev = (struct task_struct *)ctx[1];
+    struct task_struct *next = (struct task_struct *)ctx[2];
+    u64 now = bpf_ktime_get_ns();
+    u32 prev_pid = prev->pid;   // TID: 0 is the idle task
+    u32 prev_tgid = prev->tgid; // Per-process accounting key
+    u32 next_pid = next->pid;   // TID: wakeups are per thread
+    u32 zero = 0;
+
+    // 1. Retrieve the time the outgoing task was switched in on this CPU
+    struct slice *st = bpf_map_lookup_elem(&start_times, &zero);
+    if (!st)
+        return 0;
+
+    // LOGIC A: Handle the process leaving the CPU (prev_pid)
+    // A zero start time means the agent attached mid-slice; skip that partial slice.
+    if (prev_pid != 0 && st->start_ns != 0)
+    {
+        // 2. Calculate runtime duration (Current Time - Start Time)
+        u64 delta = now - st->start_ns;
+
+        // 3. Account the slice as busy time for this CPU (idle is PID 0)
+        u64 *busy = bpf_map_lookup_elem(&cpu_busy, &zero);
+        if (busy)
+            *busy += delta;
+
+        // 3b. Weight the slice by the clock it ran at (0 = no cpufreq, skipped)
+        u32 cpu = bpf_get_smp_processor_id();
+        u32 *mhz = bpf_map_lookup_elem(&cpu_freq, &cpu);
+        u64 *busy_mhz = bpf_map_lookup_elem(&cpu_busy_mhz, &zero);
+        if (mhz && busy_mhz)
+            *busy_mhz += delta * *mhz;
+
+        // 4. Add this duration to this CPU's accumulator for the process.
+        // Tracepoints run with preemption disabled, so a plain add is safe here.
+        u64 *total = bpf_map_lookup_elem(&cpu_usage, &prev_tgid);
+        if (total)
+            *total += delta;
+        else
+        {
+            // First time seeing this process, initialize entry
+            u64 init = delta;
+            if (bpf_map_update_elem(&cpu_usage, &prev_tgid, &init, BPF_ANY))
+            {
+                struct map_errors *err = errors();
+                if (err)
+                    err->usage_update += 1;
+            }
+        }
+
+        // 5. Add it to the cgroup's accumulator as well.
+        // The tracepoint fires before the switch, so 'current' is still prev.
+        u64 cgid = bpf_get_current_cgroup_id();
+        u64 *cg_total = bpf_map_lookup_elem(&cgroup_usage, &cgid);
+        if (cg_total)
+            *cg_total += delta;
+        else if (bpf_map_update_elem(&cgroup_usage, &cgid, &delta, BPF_ANY))
+        {
+            struct map_errors *err = errors();
+            if (err)
+                err->cgroup_update += 1;
+        }
+    }
+
+    // LOGIC B: Handle the process entering the CPU (next_pid)
+    // We simply mark the current timestamp so we can calculate duration later.
+    st->start_ns = now;
+    st->busy = next_pid != 0;
+
+    // LOGIC C: If next was woken up, its wait for this CPU ends now.
+    u64 *woke = bpf_map_lookup_elem(&wakeup_ts, &next_pid);
+    if (woke)
+    {
+        u64 delay_us = (now - *woke) / 1000;
+        bpf_map_delete_elem(&wakeup_ts, &next_pid);
+
+        u32 slot = log2_u64(delay_us);
+        if (slot >= RUNQ_SLOTS)
+            slot = RUNQ_SLOTS - 1;
+        struct runq_hist *hist = bpf_map_lookup_elem(&runq_latency, &zero);
+        if (hist)
+            hist->slots[slot] += 1;
+    }
+    return 0;
+}
+
+/*
+ * HOOK: tp_btf/cpu_frequency
+ * The cpufreq governor changed a CPU's clock.
+ * ctx[0] = new frequency (kHz), ctx[1] = CPU id.
+ * A slice that spans a change is weighted by the clock at its end; at 1 Hz
+ * polling and millisecond slices that error is negligible.
+ */
+SEC("tp_btf/cpu_frequency")
+int handle_cpu_frequency(u64 *ctx)
+{
+    u32 khz = (u32)ctx[0];
+    u32 cpu = (u32)ctx[1];
+    u32 mhz = khz / 1000;
+    bpf_map_update_elem(&cpu_freq, &cpu, &mhz, BPF_ANY);
+    return 0;
+}
+
+/*
+ * HOOK: tp_btf/sched_process_exit
+ * Triggered when a thread terminates. ctx[0] = the exiting task.
+ * When the whole process goes (its last thread exits), hands the TGID to the
+ * poller, which drains its final runtime and then deletes the entry, so
+ * short-lived processes are not lost between polls.
+ */
+SEC("tp_btf/sched_process_exit")
+int handle_process_exit(u64 *ctx)
+{
+    struct task_struct *p = (struct task_struct *)ctx[0];
+    u32 tgid = p->tgid;
+
+    // do_exit has already counted this thread out of signal->live. Until it
+    // reaches 0, other threads still run and charge the process entry: the
+    // leader may exit first, so testing TID == TGID is not enough.
+    if (p->signal->live.counter != 0)
+        return 0;
+
+    u32 *ev = bpf_ringbuf_reserve(&exited_pids, sizeof(*ev), 0);
+    if (!ev)
+    {
+        // Poller is behind: drop the entry now so the map stays bounded.
+        bpf_map_delete_elem(&cpu_usage, &tgid);
+        struct map_errors *err = errors();
+        if (err)
+            err->exit_dropped += 1;
+        return 0;
+    }
+    *ev = tgid;
+    // The poller drains on its own tick; skip the wakeup to keep exits cheap.
+    bpf_ringbuf_submit(ev, BPF_RB_NO_WAKEUP);
+    return 0;
+}
+char _license[] SEC("license") = "GPL";
\ No newline at end of file
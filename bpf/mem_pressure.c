@@ -0,0 +1,138 @@
+// go:build ignore
+#include <linux/bpf.h>
+#include "../bpf/headers/bpf_helpers.h"
+
+typedef unsigned int u32;
+typedef unsigned long long u64;
+
+/* * MEMORY PRESSURE PROBES
+ * None of these hooks read tracepoint fields, so no per-vendor layout is
+ * needed: the event itself is the signal. Works on Core and Tegra kernels alike.
+ */
+
+/* TUNABLES
+ * Set by userspace before load (rodata).
+ * stall_event_ns: a single direct-reclaim stall at least this long wakes userspace.
+ */
+volatile const u64 stall_event_ns = 1000000;
+
+/* EVENT KINDS */
+#define MEM_EVENT_STALL 0
+#define MEM_EVENT_OOM 1
+
+struct mem_event
+{
+    u64 stall_ns; // Stall duration (MEM_EVENT_STALL only)
+    u32 kind;     // MEM_EVENT_STALL or MEM_EVENT_OOM
+    u32 pid;      // Task that stalled / current task at OOM
+};
+
+/* * AGGREGATES
+ * Cumulative counters, one copy per CPU. Userspace sums and differences them.
+ */
+struct mem_stats
+{
+    u64 stall_ns;  // Total time tasks spent in direct reclaim
+    u64 stalls;    // Number of direct-reclaim episodes
+    u64 oom_kills; // Number of OOM victims marked
+};
+
+/* MAPS */
+struct
+{
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __type(key, u32);
+    __type(value, struct mem_stats);
+    __uint(max_entries, 1);
+} mem_stats SEC(".maps");
+
+// When each task entered direct reclaim. LRU so a missed 'end' cannot leak entries.
+// Key: TID (u32), Value: Timestamp in ns (u64)
+struct
+{
+    __uint(type, BPF_MAP_TYPE_LRU_HASH);
+    __type(key, u32);
+    __type(value, u64);
+    __uint(max_entries, 4096);
+} reclaim_start SEC(".maps");
+
+// Pressure spikes pushed to userspace between its regular samples.
+struct
+{
+    __uint(type, BPF_MAP_TYPE_RINGBUF);
+    __uint(max_entries, 4096);
+} mem_events SEC(".maps");
+
+/*
+ * HOOK: tracepoint/vmscan/mm_vmscan_direct_reclaim_begin
+ * An allocating task ran out of free pages and must reclaim memory itself.
+ */
+SEC("tracepoint/vmscan/mm_vmscan_direct_reclaim_begin")
+int handle_reclaim_begin(void *ctx)
+{
+    u32 tid = (u32)bpf_get_current_pid_tgid();
+    u64 now = bpf_ktime_get_ns();
+    bpf_map_update_elem(&reclaim_start, &tid, &now, BPF_ANY);
+    return 0;
+}
+
+/*
+ * HOOK: tracepoint/vmscan/mm_vmscan_direct_reclaim_end
+ * The task is done reclaiming; the time in between was a stall.
+ */
+SEC("tracepoint/vmscan/mm_vmscan_direct_reclaim_end")
+int handle_reclaim_end(void *ctx)
+{
+    u32 tid = (u32)bpf_get_current_pid_tgid();
+    u32 zero = 0;
+
+    u64 *st = bpf_map_lookup_elem(&reclaim_start, &tid);
+    if (!st)
+        return 0;
+    u64 delta = bpf_ktime_get_ns() - *st;
+    bpf_map_delete_elem(&reclaim_start, &tid);
+
+    struct mem_stats *stats = bpf_map_lookup_elem(&mem_stats, &zero);
+    if (stats)
+    {
+        stats->stall_ns += delta;
+        stats->stalls += 1;
+    }
+
+    // Only long stalls are worth waking userspace for.
+    if (delta < stall_event_ns)
+        return 0;
+
+    struct mem_event *ev = bpf_ringbuf_reserve(&mem_events, sizeof(*ev), 0);
+    if (!ev)
+        return 0;
+    ev->stall_ns = delta;
+    ev->kind = MEM_EVENT_STALL;
+    ev->pid = tid;
+    bpf_ringbuf_submit(ev, 0);
+    return 0;
+}
+
+/*
+ * HOOK: tracepoint/oom/mark_victim
+ * The OOM killer picked a victim: the node is past the point of pressure.
+ */
+SEC("tracepoint/oom/mark_victim")
+int handle_oom_victim(void *ctx)
+{
+    u32 zero = 0;
+
+    struct mem_stats *stats = bpf_map_lookup_elem(&mem_stats, &zero);
+    if (stats)
+        stats->oom_kills += 1;
+
+    struct mem_event *ev = bpf_ringbuf_reserve(&mem_events, sizeof(*ev), 0);
+    if (!ev)
+        return 0;
+    ev->stall_ns = 0;
+    ev->kind = MEM_EVENT_OOM;
+    ev->pid = (u32)bpf_get_current_pid_tgid();
+    bpf_ringbuf_submit(ev, 0);
+    return 0;
+}
+char _license[] SEC("license") = "GPL";
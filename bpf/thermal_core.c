@@ -4,6 +4,8 @@
 
 typedef unsigned char u8;
 typedef unsigned int u32;
+typedef int s32;
+typedef unsigned long long u64;
 
 /* * STANDARD THERMAL LAYOUT
  * Used by RPi 5. Temperature field is at offset 20.
@@ -17,59 +19,124 @@ struct thermal_core
     int temp; // Offset 20: Temp in milli-Celsius
 };
 
+/* TUNABLES
+ * Set by userspace before load (rodata), so thresholds change without recompiling.
+ * temp_delta_mc: minimum movement (milli-Celsius) that is worth reporting.
+ * warm_trip_mc / hot_trip_mc: crossing either trip is always reported.
+ */
+volatile const u32 temp_delta_mc = 500;
+volatile const u32 warm_trip_mc = 60000;
+volatile const u32 hot_trip_mc = 80000;
+
+/* PLAUSIBLE RANGE
+ * The tracepoint's temp is signed. Zones without a sensor behind them (Tegra cv*
+ * zones, offline zones) report values like -256000; such readings are dropped
+ * instead of being taken for the hottest zone.
+ */
+#define TEMP_MIN_MC (-40000)
+#define TEMP_MAX_MC 200000
+
+/* EVENT
+ * Pushed to userspace through the ring buffer when a zone's temperature changes meaningfully.
+ */
+struct thermal_event
+{
+    u32 id;        // Thermal zone id from the tracepoint
+    s32 temp_mc;   // Temp in milli-Celsius
+    s32 prev_mc;   // Last temperature reported to userspace for this zone
+    u32 pad;
+    u64 ts_ns;     // bpf_ktime_get_ns() of the reading
+    char zone[16]; // Thermal zone name (e.g. "CPU-therm")
+};
+
+/* * ZONE STATE
+ * One entry per thermal zone. Boards expose several zones (CPU, GPU, SOC0-2, tj)
+ * with different throttling behavior, so each keeps its own reading.
+ */
+struct zone_state
+{
+    s32 temp_mc;     // Latest temperature in milli-Celsius
+    s32 reported_mc; // Last temperature pushed to userspace (valid once reported is set)
+    u64 updated_ns;  // bpf_ktime_get_ns() of the latest reading
+    u32 reported;    // Nonzero once a reading of this zone was pushed
+    char name[16];   // Zone name, copied once when the zone is first seen
+};
+
 /* MAPS */
-// Stores latest temperature for the zone (Key 0)
+// Per-zone state. Key: tracepoint 'id' field.
 struct
 {
-    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __uint(type, BPF_MAP_TYPE_HASH);
     __type(key, u32);
-    __type(value, u32);
-    __uint(max_entries, 1);
-} zone_temps SEC(".maps");
+    __type(value, struct zone_state);
+    __uint(max_entries, 32);
+} zones SEC(".maps");
 
-// Stores the Name of the thermal zone (e.g. "CPU-therm")
+// Event channel to userspace. Stays silent while temperatures are stable.
 struct
 {
-    __uint(type, BPF_MAP_TYPE_ARRAY);
-    __type(key, u32);
-    __type(value, char[16]);
-    __uint(max_entries, 1);
-} zone_names SEC(".maps");
+    __uint(type, BPF_MAP_TYPE_RINGBUF);
+    __uint(max_entries, 4096);
+} thermal_events SEC(".maps");
 
-// Flag to ensure we only capture the name once to save cycles
-struct
+// crossed reports whether moving from prev to now crosses the given trip point.
+// A reading at the trip point is still below it, as in classifyTemp (temp > trip).
+static __always_inline int crossed(s32 prev, s32 now, u32 trip)
 {
-    __uint(type, BPF_MAP_TYPE_ARRAY);
-    __type(key, u32);
-    __type(value, u32);
-    __uint(max_entries, 1);
-} zone_count SEC(".maps");
+    return (prev <= (s32)trip) != (now <= (s32)trip);
+}
 
 SEC("tracepoint/thermal/thermal_temperature")
 int handle_thermal_temp(struct thermal_core *ctx)
 {
-    u32 zero = 0;
-    u32 temp_mc = ctx->temp;
+    u32 id = ctx->id;
+    s32 temp_mc = ctx->temp;
+    u64 now = bpf_ktime_get_ns();
 
-    // Calculate pointer to the variable-length string name
-    u32 offset = ctx->__data_loc_thermal_zone & 0xFFFF;
-    const char *zone_ptr = (const char *)ctx + offset;
-    char namebuf[16];
+    if (temp_mc <= TEMP_MIN_MC || temp_mc >= TEMP_MAX_MC)
+        return 0;
 
-    // Read kernel string safely into buffer
-    bpf_probe_read_str(namebuf, sizeof(namebuf), zone_ptr);
-
-    // Initialization check: Store the name only if we haven't yet
-    u32 *count_ptr = bpf_map_lookup_elem(&zone_count, &zero);
-    if (count_ptr && *count_ptr == 0)
+    struct zone_state *zs = bpf_map_lookup_elem(&zones, &id);
+    if (!zs)
     {
-        bpf_map_update_elem(&zone_names, &zero, &namebuf, BPF_ANY);
-        u32 newcount = 1;
-        bpf_map_update_elem(&zone_count, &zero, &newcount, BPF_ANY);
+        // First reading from this zone: resolve its name once.
+        // The name is a variable-length string located via __data_loc.
+        struct zone_state init = {};
+        u32 offset = ctx->__data_loc_thermal_zone & 0xFFFF;
+        const char *zone_ptr = (const char *)ctx + offset;
+        bpf_probe_read_str(init.name, sizeof(init.name), zone_ptr);
+        bpf_map_update_elem(&zones, &id, &init, BPF_NOEXIST);
+
+        zs = bpf_map_lookup_elem(&zones, &id);
+        if (!zs)
+            return 0;
     }
 
-    // Always update the latest temperature
-    bpf_map_update_elem(&zone_temps, &zero, &temp_mc, BPF_ANY);
+    // Always keep the latest reading for this zone
+    zs->temp_mc = temp_mc;
+    zs->updated_ns = now;
+
+    // Filter: only wake userspace when the zone's reading is new, moved by at
+    // least temp_delta_mc, or crossed a trip point. Stable temperatures cost nothing.
+    s32 prev = zs->reported_mc;
+    u32 diff = temp_mc > prev ? temp_mc - prev : prev - temp_mc;
+    if (zs->reported && diff < temp_delta_mc &&
+        !crossed(prev, temp_mc, warm_trip_mc) && !crossed(prev, temp_mc, hot_trip_mc))
+        return 0;
+
+    struct thermal_event *ev = bpf_ringbuf_reserve(&thermal_events, sizeof(*ev), 0);
+    if (!ev)
+        return 0;
+    ev->id = id;
+    ev->temp_mc = temp_mc;
+    ev->prev_mc = prev;
+    ev->pad = 0;
+    ev->ts_ns = now;
+    __builtin_memcpy(ev->zone, zs->name, sizeof(ev->zone));
+
+    bpf_ringbuf_submit(ev, 0);
+    zs->reported_mc = temp_mc;
+    zs->reported = 1;
     return 0;
 }
 char _license[] SEC("license") = "GPL";
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 typedef unsigned char u8;
 typedef unsigned int u32;
+typedef int s32;
+typedef unsigned long long u64;
 
 /* * JETSON TEGRA THERMAL LAYOUT
  * Used by Orin Nano. Temperature field is at offset 24.
@@ -17,54 +19,106 @@ struct thermal_tegra
     int temp;                    // Offset 24: Temp in milli-Celsius
 };
 
+/* TUNABLES (same semantics as thermal_core.c) */
+volatile const u32 temp_delta_mc = 500;
+volatile const u32 warm_trip_mc = 60000;
+volatile const u32 hot_trip_mc = 80000;
+
+/* PLAUSIBLE RANGE (same as thermal_core.c): cv* and offline zones report -256000 */
+#define TEMP_MIN_MC (-40000)
+#define TEMP_MAX_MC 200000
+
+struct thermal_event
+{
+    u32 id;
+    s32 temp_mc;
+    s32 prev_mc;
+    u32 pad;
+    u64 ts_ns;
+    char zone[16];
+};
+
+struct zone_state
+{
+    s32 temp_mc;
+    s32 reported_mc;
+    u64 updated_ns;
+    u32 reported;
+    char name[16];
+};
+
 /* MAPS */
 struct
 {
-    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __uint(type, BPF_MAP_TYPE_HASH);
     __type(key, u32);
-    __type(value, u32);
-    __uint(max_entries, 1);
-} zone_temps SEC(".maps");
+    __type(value, struct zone_state);
+    __uint(max_entries, 32);
+} zones SEC(".maps");
 
 struct
 {
-    __uint(type, BPF_MAP_TYPE_ARRAY);
-    __type(key, u32);
-    __type(value, char[16]);
-    __uint(max_entries, 1);
-} zone_names SEC(".maps");
+    __uint(type, BPF_MAP_TYPE_RINGBUF);
+    __uint(max_entries, 4096);
+} thermal_events SEC(".maps");
 
-struct
+// crossed reports whether moving from prev to now crosses the given trip point.
+// A reading at the trip point is still below it, as in classifyTemp (temp > trip).
+static __always_inline int crossed(s32 prev, s32 now, u32 trip)
 {
-    __uint(type, BPF_MAP_TYPE_ARRAY);
-    __type(key, u32);
-    __type(value, u32);
-    __uint(max_entries, 1);
-} zone_count SEC(".maps");
+    return (prev <= (s32)trip) != (now <= (s32)trip);
+}
 
 SEC("tracepoint/thermal/thermal_temperature")
 int handle_thermal_temp(struct thermal_tegra *ctx)
 {
-    u32 zero = 0;
-    u32 temp_mc = ctx->temp;
-
-    // 1. Read Zone Name (Using Tegra-specific offset calculation)
-    u32 offset = ctx->__data_loc_thermal_zone & 0xFFFF;
-    const char *zone_ptr = (const char *)ctx + offset;
-    char namebuf[16];
-    bpf_probe_read_str(namebuf, sizeof(namebuf), zone_ptr);
-
-    // 2. Store Name (Once)
-    u32 *count_ptr = bpf_map_lookup_elem(&zone_count, &zero);
-    if (count_ptr && *count_ptr == 0)
+    u32 id = ctx->id;
+    s32 temp_mc = ctx->temp;
+    u64 now = bpf_ktime_get_ns();
+
+    if (temp_mc <= TEMP_MIN_MC || temp_mc >= TEMP_MAX_MC)
+        return 0;
+
+    // 1. Find or create the zone (Using Tegra-specific offset calculation for the name)
+    struct zone_state *zs = bpf_map_lookup_elem(&zones, &id);
+    if (!zs)
     {
-        bpf_map_update_elem(&zone_names, &zero, &namebuf, BPF_ANY);
-        u32 newcount = 1;
-        bpf_map_update_elem(&zone_count, &zero, &newcount, BPF_ANY);
+        struct zone_state init = {};
+        u32 offset = ctx->__data_loc_thermal_zone & 0xFFFF;
+        const char *zone_ptr = (const char *)ctx + offset;
+        bpf_probe_read_str(init.name, sizeof(init.name), zone_ptr);
+        bpf_map_update_elem(&zones, &id, &init, BPF_NOEXIST);
+
+        zs = bpf_map_lookup_elem(&zones, &id);
+        if (!zs)
+            return 0;
     }
 
-    // 3. Store Temp
-    bpf_map_update_elem(&zone_temps, &zero, &temp_mc, BPF_ANY);
+    // 2. Store Temp
+    zs->temp_mc = temp_mc;
+    zs->updated_ns = now;
+
+    // 3. Filter: report only new, moved or trip-crossing readings
+    s32 prev = zs->reported_mc;
+    u32 diff = temp_mc > prev ? temp_mc - prev : prev - temp_mc;
+    if (zs->reported && diff < temp_delta_mc &&
+        !crossed(prev, temp_mc, warm_trip_mc) && !crossed(prev, temp_mc, hot_trip_mc))
+        return 0;
+
+    // 4. Push Event
+    struct thermal_event *ev = bpf_ringbuf_reserve(&thermal_events, sizeof(*ev), 0);
+    if (!ev)
+        return 0;
+    ev->id = id;
+    ev->temp_mc = temp_mc;
+    ev->prev_mc = prev;
+    ev->pad = 0;
+    ev->ts_ns = now;
+    __builtin_memcpy(ev->zone, zs->name, sizeof(ev->zone));
+
+    bpf_ringbuf_submit(ev, 0);
+    zs->reported_mc = temp_mc;
+    zs->reported = 1;
     return 0;
 }
 char _license[] SEC("license") = "GPL";
\ No newline at end of file
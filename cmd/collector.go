@@ -0,0 +1,170 @@
+package cmd
+
+import (
+	"fmt"
+	"log"
+	"slices"
+	"sync/atomic"
+	"time"
+)
+
+// -----------------------------------------------------------------------------
+// Collector Registry & Sampling Loop
+// -----------------------------------------------------------------------------
+//
+// Every local metrics source implements Collector and registers itself from
+// its file's init(). One loop samples all of them: collectors due on the same
+// tick are sampled back to back with the same timestamp, and each one writes
+// its reading straight into LocalMetrics. Adding a source (network, disk, ...)
+// means adding a file, not another goroutine and channel in runPeer.
+
+// Collector is one local metrics source driven by the sampling loop.
+type Collector interface {
+	// Interval is how often the collector wants to be sampled.
+	// The loop rounds it to a multiple of its base tick.
+	Interval() time.Duration
+	// Sample reads the source and publishes the result into m.
+	// It is only ever called from the sampling loop, never concurrently.
+	Sample(now time.Time, m *LocalMetrics) error
+	Close()
+}
+
+// collectorSpec is a registered collector constructor.
+// wake requests an immediate, off-tick sample of this collector; sources
+// with kernel events (reclaim stalls, thermal trips) use it to react early.
+type collectorSpec struct {
+	name     string
+	optional bool // An open failure disables the collector instead of aborting
+	open     func(wake func()) (Collector, error)
+}
+
+var collectorRegistry []collectorSpec
+
+// registerCollector adds a collector to the registry. Call it from init().
+func registerCollector(name string, optional bool, open func(wake func()) (Collector, error)) {
+	collectorRegistry = append(collectorRegistry, collectorSpec{name: name, optional: optional, open: open})
+}
+
+// minSamplingTick bounds the base tick when collector intervals share no larger divisor.
+const minSamplingTick = 10 * time.Millisecond
+
+// startCollectors opens the named collectors (all registered ones if none are
+// named) and starts the sampling loop that feeds m. onSample, if set, runs
+// after every pass that sampled at least one collector.
+// The returned function stops the loop and closes every collector.
+func startCollectors(m *LocalMetrics, onSample func(), names ...string) (func(), error) {
+	var collectors []Collector
+	var labels []string
+	closeAll := func() {
+		for _, c := range collectors {
+			c.Close()
+		}
+	}
+
+	// Wakes carry the collector's index; pending keeps at most one in flight
+	// per collector, so the buffer never fills and wake never blocks.
+	wakes := make(chan int, len(collectorRegistry))
+	pending := make([]atomic.Bool, len(collectorRegistry))
+
+	for _, spec := range collectorRegistry {
+		if len(names) > 0 && !slices.Contains(names, spec.name) {
+			continue
+		}
+		i := len(collectors)
+		c, err := spec.open(func() {
+			if !pending[i].Swap(true) {
+				wakes <- i
+			}
+		})
+		if err != nil {
+			if spec.optional {
+				log.Printf("%s disabled: %v", spec.name, err)
+				continue
+			}
+			closeAll()
+			return nil, fmt.Errorf("%s init failed: %v", spec.name, err)
+		}
+		collectors = append(collectors, c)
+		labels = append(labels, spec.name)
+	}
+	if len(collectors) == 0 {
+		return nil, fmt.Errorf("no collectors available")
+	}
+
+	// The base tick is the largest period that divides every interval.
+	var tick time.Duration
+	for _, c := range collectors {
+		tick = gcdDuration(tick, c.Interval())
+	}
+	tick = max(tick, minSamplingTick)
+	every := make([]int64, len(collectors))
+	for i, c := range collectors {
+		every[i] = max(int64(c.Interval()/tick), 1)
+	}
+
+	sample := func(i int, now time.Time) {
+		if err := collectors[i].Sample(now, m); err != nil {
+			log.Printf("[%s] sample failed: %v", labels[i], err)
+		}
+	}
+
+	done := make(chan struct{})
+	stopped := make(chan struct{})
+	go func() {
+		defer close(stopped)
+		// Ticks sit on wall-clock multiples of the base tick, so a slower
+		// collector is always sampled together with the faster ones, and nodes
+		// with synced clocks sample at the same instants.
+		next := time.Now().Truncate(tick).Add(tick)
+		timer := time.NewTimer(time.Until(next))
+		defer timer.Stop()
+
+		for {
+			select {
+			case <-done:
+				return
+			case i := <-wakes:
+				pending[i].Store(false)
+				sample(i, time.Now())
+				if onSample != nil {
+					onSample()
+				}
+				continue
+			case <-timer.C:
+			}
+
+			now := time.Now()
+			n := next.UnixNano() / int64(tick)
+			sampled := false
+			for i := range collectors {
+				if n%every[i] == 0 {
+					sample(i, now)
+					sampled = true
+				}
+			}
+			if sampled && onSample != nil {
+				onSample()
+			}
+
+			// A pass that overran skips the ticks it missed instead of bunching up.
+			next = next.Add(tick)
+			if late := time.Since(next); late > 0 {
+				next = next.Add(late.Truncate(tick) + tick)
+			}
+			timer.Reset(time.Until(next))
+		}
+	}()
+
+	return func() {
+		close(done)
+		<-stopped
+		closeAll()
+	}, nil
+}
+
+func gcdDuration(a, b time.Duration) time.Duration {
+	for b != 0 {
+		a, b = b, a%b
+	}
+	return a
+}
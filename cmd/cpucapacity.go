@@ -0,0 +1,93 @@
+package cmd
+
+import (
+	"fmt"
+	"runtime"
+	"sync/atomic"
+)
+
+// cpuCapacity tracks how many CPUs the node has online right now.
+// GOMAXPROCS describes the Go runtime, not the machine: it follows manual
+// tuning and the agent's own cgroup quota, and misses CPU hotplug (Jetson
+// power modes switch cores off). The online mask is re-read every poll
+// through a persistent fd, so a power-mode change is picked up on the next sample.
+//
+// The agent's cgroup quota is deliberately ignored: cpu_busy counts the
+// whole node's busy time, so it must be divided by the whole node's CPUs.
+// An agent confined to half a CPU would otherwise report a node 12.5% busy
+// on 4 cores as full.
+type cpuCapacity struct {
+	online *procFile // /sys/devices/system/cpu/online, e.g. "0-3,6"
+	mask   []bool    // Online state per CPU id, reused between refreshes
+}
+
+func openCPUCapacity() (*cpuCapacity, error) {
+	online, err := openProcFile("/sys/devices/system/cpu/online", 256)
+	if err != nil {
+		return nil, err
+	}
+	return &cpuCapacity{online: online}, nil
+}
+
+func (c *cpuCapacity) Close() {
+	c.online.Close()
+}
+
+// refresh re-reads the online mask for a machine with nCPU possible CPUs.
+// It returns the number of online CPUs and the online state of each CPU.
+func (c *cpuCapacity) refresh(nCPU int) (float64, []bool, error) {
+	if len(c.mask) != nCPU {
+		c.mask = make([]bool, nCPU)
+	}
+	buf, err := c.online.read()
+	if err != nil {
+		return 0, nil, err
+	}
+	online := parseCPUList(buf, c.mask)
+	if online == 0 {
+		return 0, nil, fmt.Errorf("no online CPUs in %q", buf)
+	}
+	return float64(online), c.mask, nil
+}
+
+// parseCPUList fills mask from a kernel CPU list like "0-3,6" and returns the CPU count.
+// CPUs beyond len(mask) are ignored.
+func parseCPUList(b []byte, mask []bool) int {
+	for i := range mask {
+		mask[i] = false
+	}
+	count := 0
+	for len(b) > 0 {
+		lo, rest, ok := parseUint(b)
+		if !ok {
+			break
+		}
+		hi := lo
+		if len(rest) > 0 && rest[0] == '-' {
+			hi, rest, ok = parseUint(rest[1:])
+			if !ok {
+				break
+			}
+		}
+		for cpu := lo; cpu <= hi && cpu < uint64(len(mask)); cpu++ {
+			if !mask[cpu] {
+				mask[cpu] = true
+				count++
+			}
+		}
+		b = rest
+	}
+	return count
+}
+
+// cpuCapacityMilli publishes the latest capacity (in thousandths of a CPU)
+// for consumers outside the poller, such as job cost accounting.
+var cpuCapacityMilli atomic.Int64
+
+// currentCPUCapacity returns the node's online CPUs as last seen by the CPU collector.
+func currentCPUCapacity() float64 {
+	if v := cpuCapacityMilli.Load(); v > 0 {
+		return float64(v) / 1000
+	}
+	return float64(runtime.NumCPU())
+}
@@ -0,0 +1,36 @@
+package cmd
+
+import (
+	"reflect"
+	"testing"
+)
+
+func TestParseCPUList(t *testing.T) {
+	tests := []struct {
+		name  string
+		in    string
+		nCPU  int
+		count int
+		mask  []bool
+	}{
+		{"range", "0-3\n", 4, 4, []bool{true, true, true, true}},
+		{"single", "0\n", 2, 1, []bool{true, false}},
+		{"hotplugged out", "0-1,4\n", 6, 3, []bool{true, true, false, false, true, false}},
+		{"ranges and singles", "0,2-3,5", 6, 4, []bool{true, false, true, true, false, true}},
+		{"beyond the mask", "0-7", 4, 4, []bool{true, true, true, true}},
+		{"duplicates count once", "0-2,1", 3, 3, []bool{true, true, true}},
+		{"empty", "\n", 2, 0, []bool{false, false}},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			mask := make([]bool, tt.nCPU)
+			for i := range mask {
+				mask[i] = true // Stale state from a previous refresh must be cleared
+			}
+			count := parseCPUList([]byte(tt.in), mask)
+			if count != tt.count || !reflect.DeepEqual(mask, tt.mask) {
+				t.Errorf("parseCPUList(%q) = %d, %v; want %d, %v", tt.in, count, mask, tt.count, tt.mask)
+			}
+		})
+	}
+}
@@ -0,0 +1,71 @@
+package cmd
+
+import (
+	"fmt"
+
+	"github.com/cilium/ebpf"
+)
+
+// cpuFreqs holds the hardware maximum clock of each CPU.
+// A zero entry means the CPU has no cpufreq driver (VMs, some SBC kernels);
+// such CPUs count at full speed.
+type cpuFreqs struct {
+	maxMHz []uint32
+}
+
+// readSysfsMHz reads a cpufreq attribute (in kHz) and returns MHz.
+func readSysfsMHz(cpu int, attr string) uint32 {
+	f, err := openProcFile(fmt.Sprintf("/sys/devices/system/cpu/cpu%d/cpufreq/%s", cpu, attr), 32)
+	if err != nil {
+		return 0
+	}
+	defer f.Close()
+	buf, err := f.read()
+	if err != nil {
+		return 0
+	}
+	khz, _, ok := parseUint(buf)
+	if !ok {
+		return 0
+	}
+	return uint32(khz / 1000)
+}
+
+// seedCPUFreqs reads each CPU's maximum and current clock from sysfs and
+// writes the current one into the BPF map. power/cpu_frequency only reports
+// changes, so without seeding a CPU that never changes clock would read 0.
+func seedCPUFreqs(freqMap *ebpf.Map, nCPU int) cpuFreqs {
+	f := cpuFreqs{maxMHz: make([]uint32, nCPU)}
+	for cpu := 0; cpu < nCPU; cpu++ {
+		f.maxMHz[cpu] = readSysfsMHz(cpu, "cpuinfo_max_freq")
+		if cur := readSysfsMHz(cpu, "scaling_cur_freq"); cur > 0 {
+			key := uint32(cpu)
+			freqMap.Update(&key, &cur, ebpf.UpdateAny)
+		}
+	}
+	return f
+}
+
+// known reports whether any CPU exposes cpufreq.
+func (f cpuFreqs) known() bool {
+	for _, m := range f.maxMHz {
+		if m > 0 {
+			return true
+		}
+	}
+	return false
+}
+
+// effectiveBusy converts one CPU's busy ns x MHz delta into busy ns at full
+// clock. busyNS is returned unchanged for CPUs without cpufreq.
+func (f cpuFreqs) effectiveBusy(cpu int, busyNS, busyMHz uint64) float64 {
+	if cpu >= len(f.maxMHz) || f.maxMHz[cpu] == 0 {
+		return float64(busyNS)
+	}
+	eff := float64(busyMHz) / float64(f.maxMHz[cpu])
+	// A slice whose clock was raised right before it ended can overshoot.
+	if eff > float64(busyNS) {
+		eff = float64(busyNS)
+	}
+	return eff
+}
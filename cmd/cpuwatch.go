@@ -1,165 +1,728 @@
 package cmd
 
 import (
+	"encoding/binary"
+	"errors"
 	"fmt"
 	"log"
 	"os"
 	"os/signal"
 	"runtime"
-	"strings"
+	"sort"
+	"strconv"
+	"sync/atomic"
 	"syscall"
 	"time"
 
 	"github.com/cilium/ebpf"
 	"github.com/cilium/ebpf/link"
+	"github.com/cilium/ebpf/ringbuf"
 	"github.com/cilium/ebpf/rlimit"
 	"github.com/spf13/cobra"
+	"golang.org/x/sys/unix"
 )
 
 var cpuwatchCmd = &cobra.Command{
 	Use:   "cpuwatch",
-	Short: "Collect CPU usage (Auto-Detect Core vs Tegra)",
+	Short: "Collect CPU usage (CO-RE, one object for every board)",
 	Run:   runCPUWatch,
 }
 
+// cpuPerPID enables the optional per-PID breakdown on top of the node-level number.
+var cpuPerPID bool
+
 func init() {
 	rootCmd.AddCommand(cpuwatchCmd)
+	rootCmd.PersistentFlags().BoolVar(&cpuPerPID, "cpu-per-pid", false, "Also walk the per-PID CPU map and log the top consumers")
+	registerCollector("CPU", false, openCPUCollector)
+}
+
+// cpuTopN is how many PIDs the per-PID detail view reports each poll.
+const cpuTopN = 5
+
+// Generate the single CO-RE object with the correct include path for Ubuntu headers.
+// Field offsets are relocated against the running kernel's BTF at load time.
+//go:generate go run github.com/cilium/ebpf/cmd/bpf2go cpu_btf ../bpf/cpu_btf.c -- -O2 -target bpf -I/usr/include/x86_64-linux-gnu
+
+// CPUReading is one CPU sample.
+type CPUReading struct {
+	Percent   float64   // Node utilization across all cores
+	RunqP50Us float64   // Median wakeup-to-run delay over the last poll (µs)
+	RunqP99Us float64   // 99th percentile wakeup-to-run delay over the last poll (µs)
+	CoreBusy  []float64 // Busy % of each CPU, indexed by CPU id
+	IdleCores int       // CPUs below coreIdlePercent
+	Effective float64   // Percent scaled by clock/max clock: capacity actually consumed
+	FreqRatio float64   // Busy-time weighted clock/max clock (0 = no cpufreq)
+
+	// The agent's own footprint, to catch per-PID state that keeps growing.
+	TrackedPIDs int    // PIDs the poller remembers between polls (--cpu-per-pid)
+	HeapBytes   uint64 // Live and not-yet-swept heap objects of the agent
 }
 
-// Generate BOTH binaries with the correct include path for Ubuntu headers.
-//go:generate go run github.com/cilium/ebpf/cmd/bpf2go cpu_core ../bpf/cpu_core.c -- -O2 -target bpf -I/usr/include/x86_64-linux-gnu
-//go:generate go run github.com/cilium/ebpf/cmd/bpf2go cpu_tegra ../bpf/cpu_tegra.c -- -O2 -target bpf -I/usr/include/x86_64-linux-gnu
+// coreIdlePercent is the busy % under which a core counts as free for a
+// single-threaded job: it would get (almost) the whole core to itself.
+const coreIdlePercent = 10.0
 
-// cpuBPF abstracts the specific eBPF objects (Tegra vs Core)
+// cpuBPF holds the loaded eBPF objects of the CPU collector
 type cpuBPF struct {
-	progSwitch *ebpf.Program
-	progExit   *ebpf.Program
-	cpuMap     *ebpf.Map
-	cleanup    func()
+	progSwitch    *ebpf.Program
+	progExit      *ebpf.Program
+	progWakeup    *ebpf.Program
+	progWakeupNew *ebpf.Program
+	progFreq      *ebpf.Program
+	cpuMap        *ebpf.Map // Per-process (TGID) runtime (detail view only)
+	busyMap       *ebpf.Map // Per-CPU busy nanoseconds (headline number)
+	busyMHzMap    *ebpf.Map // Per-CPU busy nanoseconds x clock in MHz
+	startMap      *ebpf.Map // Per-CPU start of the slice now running
+	freqMap       *ebpf.Map // Current clock per CPU id
+	runqMap       *ebpf.Map // Per-CPU log2 histogram of run-queue delay
+	cgroupMap     *ebpf.Map // Per-cgroup runtime (job cost attribution)
+	exitedMap     *ebpf.Map // Ring buffer of exited PIDs awaiting their final drain
+	errorsMap     *ebpf.Map // Per-CPU counters of failed map updates
+	cleanup       func()
 }
 
-func loadCpuTegraBPF() (*cpuBPF, error) {
-	var objs cpu_tegraObjects
-	if err := loadCpu_tegraObjects(&objs, nil); err != nil {
-		return nil, fmt.Errorf("load tegra: %v", err)
+func loadCpuBTF() (*cpuBPF, error) {
+	var objs cpu_btfObjects
+	if err := loadCpu_btfObjects(&objs, nil); err != nil {
+		// CO-RE relocation needs the kernel's own type info (CONFIG_DEBUG_INFO_BTF=y).
+		return nil, fmt.Errorf("load cpu (kernel BTF required): %v", err)
 	}
 	return &cpuBPF{
-		progSwitch: objs.HandleSchedSwitch,
-		progExit:   objs.HandleProcessExit,
-		cpuMap:     objs.CpuUsage,
-		cleanup:    func() { objs.Close() },
+		progSwitch:    objs.HandleSchedSwitch,
+		progExit:      objs.HandleProcessExit,
+		progWakeup:    objs.HandleSchedWakeup,
+		progWakeupNew: objs.HandleSchedWakeupNew,
+		progFreq:      objs.HandleCpuFrequency,
+		cpuMap:        objs.CpuUsage,
+		busyMap:       objs.CpuBusy,
+		busyMHzMap:    objs.CpuBusyMhz,
+		startMap:      objs.StartTimes,
+		freqMap:       objs.CpuFreq,
+		runqMap:       objs.RunqLatency,
+		cgroupMap:     objs.CgroupUsage,
+		exitedMap:     objs.ExitedPids,
+		errorsMap:     objs.MapErrors,
+		cleanup:       func() { objs.Close() },
 	}, nil
 }
 
-func loadCpuCoreBPF() (*cpuBPF, error) {
-	var objs cpu_coreObjects
-	if err := loadCpu_coreObjects(&objs, nil); err != nil {
-		return nil, fmt.Errorf("load core: %v", err)
-	}
-	return &cpuBPF{
-		progSwitch: objs.HandleSchedSwitch,
-		progExit:   objs.HandleProcessExit,
-		cpuMap:     objs.CpuUsage,
-		cleanup:    func() { objs.Close() },
-	}, nil
+// cpuPollInterval is how often the sampling loop reads the CPU maps.
+const cpuPollInterval = 1 * time.Second
+
+// cpuCollector owns the loaded CPU programs and the counters of the previous sample.
+type cpuCollector struct {
+	bpf      *cpuBPF
+	links    []link.Link
+	exits    *exitDrainer
+	capacity *cpuCapacity // nil when the online CPU mask is unreadable
+	numCPUs  float64
+
+	lastCPU        *pidHistory
+	pidReader      *pidMapReader
+	lastSample     time.Time
+	lastBusy       uint64
+	lastPerCore    []uint64
+	lastPerCoreMHz []uint64
+	freqs          cpuFreqs
+	lastRunq       runqHist
+	lastErrors     cpuMapErrors
 }
 
-func StartCPUCollector() (<-chan float64, func(), error) {
+func openCPUCollector(wake func()) (Collector, error) {
 	// necessary to make ebpf code work
 	if err := rlimit.RemoveMemlock(); err != nil {
-		return nil, nil, fmt.Errorf("rlimit error: %v", err)
+		return nil, fmt.Errorf("rlimit error: %v", err)
 	}
 
-	// 1. Detect Kernel
-	release := detectKernel()
-	logDebug("Kernel Detected: %s", release)
+	// 1. Load the CO-RE Object
+	// No kernel string sniffing: the loader relocates task_struct accesses
+	// against /sys/kernel/btf/vmlinux, so the same object works on every layout.
+	logDebug("Kernel Detected: %s (CO-RE)", detectKernel())
 
-	// 2. Load the Right Object
-	var loader func() (*cpuBPF, error)
-	if strings.Contains(release, "tegra") {
-		logDebug("Mode: JETSON TEGRA (Offset 28)")
+	bpf, err := loadCpuBTF()
+	if err != nil {
+		return nil, err
+	}
+	c := &cpuCollector{
+		bpf:       bpf,
+		numCPUs:   float64(runtime.NumCPU()),
+		lastCPU:   newPIDHistory(),
+		pidReader: newPIDMapReader(bpf.cpuMap),
+	}
 
-		loader = loadCpuTegraBPF
-	} else {
-		logDebug("Mode: STANDARD CORE (Offset 24)")
+	// 2. Attach Raw BTF Tracepoints
+	hooks := []struct {
+		name string
+		prog *ebpf.Program
+	}{
+		{"switch", bpf.progSwitch},
+		{"exit", bpf.progExit},
+		{"wakeup", bpf.progWakeup},
+		{"wakeup_new", bpf.progWakeupNew},
+		{"cpu_frequency", bpf.progFreq},
+	}
+	for _, h := range hooks {
+		l, err := link.AttachTracing(link.TracingOptions{Program: h.prog})
+		if err != nil {
+			c.Close()
+			return nil, fmt.Errorf("attach %s: %v", h.name, err)
+		}
+		c.links = append(c.links, l)
+	}
 
-		loader = loadCpuCoreBPF
+	// Seed each CPU's clock as soon as cpu_frequency is attached: it only
+	// reports changes, so a CPU that keeps its clock until the first poll
+	// would have none and understate that poll's frequency ratio.
+	if nCPU, err := ebpf.PossibleCPU(); err == nil {
+		c.freqs = seedCPUFreqs(bpf.freqMap, nCPU)
+	} else {
+		logDebug("[CPU] possible CPU count unavailable, clock scaling disabled: %v", err)
 	}
 
-	bpf, err := loader()
+	c.exits, err = newExitDrainer(bpf.exitedMap, bpf.cpuMap)
 	if err != nil {
-		return nil, nil, err
+		c.Close()
+		return nil, fmt.Errorf("open exit ringbuf: %v", err)
+	}
+
+	// Capacity comes from the online CPU mask, re-read every poll.
+	// Without it, fall back to the CPUs the runtime saw at startup.
+	if c.capacity, err = openCPUCapacity(); err != nil {
+		logDebug("[CPU] online CPU mask unavailable, assuming %d CPUs: %v", runtime.NumCPU(), err)
+	}
+
+	// Hand the per-cgroup map to the job executor.
+	cgroupCPU.Store(bpf.cgroupMap)
+
+	return c, nil
+}
+
+func (c *cpuCollector) Interval() time.Duration { return cpuPollInterval }
+
+func (c *cpuCollector) Close() {
+	cgroupCPU.Store(nil)
+	for _, l := range c.links {
+		l.Close()
+	}
+	if c.exits != nil {
+		c.exits.Close()
+	}
+	if c.capacity != nil {
+		c.capacity.Close()
+	}
+	c.bpf.cleanup()
+}
+
+// cgroupCPU is the per-cgroup runtime map while the CPU collector runs, nil otherwise.
+// executeDockerContainer reads it to measure what a job actually cost.
+var cgroupCPU atomic.Pointer[ebpf.Map]
+
+// cgroupRuntimeNS returns the CPU time a cgroup has used, summed across CPUs.
+// A cgroup that has not run yet (or was evicted from the LRU) reports 0.
+func cgroupRuntimeNS(id uint64) (uint64, error) {
+	m := cgroupCPU.Load()
+	if m == nil {
+		return 0, fmt.Errorf("cpu collector not running")
+	}
+	var perCPU []uint64
+	if err := m.Lookup(&id, &perCPU); err != nil {
+		if errors.Is(err, ebpf.ErrKeyNotExist) {
+			return 0, nil
+		}
+		return 0, err
+	}
+	var ns uint64
+	for _, v := range perCPU {
+		ns += v
+	}
+	return ns, nil
+}
+
+// openSlice mirrors 'struct slice' in bpf/cpu_btf.c.
+type openSlice struct {
+	StartNS uint64
+	Busy    uint64
+}
+
+// addOpenSlices adds the slice still running on each CPU to its counters.
+// The kernel only charges a slice at switch-out, so a core pegged by a task
+// that never yields would read idle until it does, then show one burst.
+// start_times is read after the counters: a slice that closes in between is
+// missed by this sample and counted by the next, never counted twice.
+func (c *cpuCollector) addOpenSlices(perCPU, perCPUMHz []uint64) {
+	var key uint32 = 0
+	var slices []openSlice
+	if err := c.bpf.startMap.Lookup(&key, &slices); err != nil || len(slices) != len(perCPU) {
+		return
+	}
+	// bpf_ktime_get_ns() is CLOCK_MONOTONIC.
+	var ts unix.Timespec
+	if err := unix.ClockGettime(unix.CLOCK_MONOTONIC, &ts); err != nil {
+		return
+	}
+	now := uint64(ts.Nano())
+	for i, s := range slices {
+		if s.Busy == 0 || s.StartNS == 0 || s.StartNS >= now {
+			continue
+		}
+		open := now - s.StartNS
+		perCPU[i] += open
+		if perCPUMHz != nil {
+			cpu := uint32(i)
+			var mhz uint32
+			if err := c.bpf.freqMap.Lookup(&cpu, &mhz); err == nil {
+				perCPUMHz[i] += open * uint64(mhz)
+			}
+		}
+	}
+}
+
+// Sample differences the kernel counters against the previous sample.
+// The first call only records the baseline.
+func (c *cpuCollector) Sample(now time.Time, m *LocalMetrics) error {
+	var key uint32 = 0
+	var perCPU []uint64
+
+	// CRITICAL SECTION: Read the in-kernel busy counter.
+	// One lookup returns the cumulative non-idle time (in ns) of every CPU.
+	if err := c.bpf.busyMap.Lookup(&key, &perCPU); err != nil {
+		return err
+	}
+	// Frequency-weighted busy time, same per-CPU layout as perCPU.
+	var perCPUMHz []uint64
+	if err := c.bpf.busyMHzMap.Lookup(&key, &perCPUMHz); err != nil || len(perCPUMHz) != len(perCPU) {
+		perCPUMHz = nil
+	}
+	c.addOpenSlices(perCPU, perCPUMHz)
+	var busy uint64
+	for _, v := range perCPU {
+		busy += v
+	}
+	totalDelta := busy - c.lastBusy
+	c.lastBusy = busy
+
+	// Rates are per wall time actually elapsed: off-schedule or late passes stay exact.
+	first := c.lastSample.IsZero()
+	intervalNS := uint64(now.Sub(c.lastSample).Nanoseconds())
+	c.lastSample = now
+
+	// Track hotplug: a Jetson switched to a 4-core power mode
+	// must divide by 4, not by the 6 cores it booted with.
+	var online []bool
+	if c.capacity != nil {
+		if cores, mask, err := c.capacity.refresh(len(perCPU)); err == nil {
+			if cores != c.numCPUs {
+				logDebug("[CPU] online CPUs changed: %.0f -> %.0f", c.numCPUs, cores)
+			}
+			c.numCPUs, online = cores, mask
+		}
 	}
+	cpuCapacityMilli.Store(int64(c.numCPUs * 1000))
+	// CRITICAL: We scale the interval by the number of CPUs because the kernel
+	// accounts for CPU time per-core. 1 second of wall time on 4 cores = 4 seconds of CPU time.
+	scaledIntervalNS := uint64(float64(intervalNS) * c.numCPUs)
 
-	// 3. Attach Tracepoints
-	hSwitch, err := link.Tracepoint("sched", "sched_switch", bpf.progSwitch, nil)
+	// The same lookup already holds one counter per CPU (the program adds
+	// each slice to the copy of the CPU it ran on), so per-core load is free.
+	// An average hides one pegged core among idle ones; single-threaded jobs
+	// need a free core, not spare capacity spread over several.
+	if c.lastPerCore == nil {
+		c.lastPerCore = make([]uint64, len(perCPU))
+		c.lastPerCoreMHz = make([]uint64, len(perCPU))
+	}
+
+	var effectiveNS float64
+	coreBusy := make([]float64, len(perCPU))
+	idleCores := 0
+	for i, v := range perCPU {
+		coreBusy[i] = float64(v-c.lastPerCore[i]) / float64(intervalNS) * 100.0
+		if coreBusy[i] > 100 {
+			coreBusy[i] = 100
+		}
+		// An offline core is not idle, it does not exist right now.
+		if coreBusy[i] < coreIdlePercent && (online == nil || online[i]) {
+			idleCores++
+		}
+		if perCPUMHz != nil {
+			effectiveNS += c.freqs.effectiveBusy(i, v-c.lastPerCore[i], perCPUMHz[i]-c.lastPerCoreMHz[i])
+			c.lastPerCoreMHz[i] = perCPUMHz[i]
+		}
+		c.lastPerCore[i] = v
+	}
+
+	// Fold the final runtime of processes that exited since the last poll,
+	// then free their entries. Without the detail view nobody needs the
+	// per-PID numbers, so the entries are only deleted.
+	retired := c.exits.drain(c.lastCPU, cpuPerPID)
+
+	// Failed updates mean the per-PID/cgroup numbers are missing runtime.
+	if errs, err := readMapErrors(c.bpf.errorsMap); err == nil {
+		if errs != c.lastErrors {
+			log.Printf("[CPU] BPF map updates failed: cpu_usage %d, cgroup_usage %d, wakeup_ts %d, exits dropped %d",
+				errs.UsageUpdate-c.lastErrors.UsageUpdate,
+				errs.CgroupUpdate-c.lastErrors.CgroupUpdate,
+				errs.WakeupUpdate-c.lastErrors.WakeupUpdate,
+				errs.ExitDropped-c.lastErrors.ExitDropped)
+			c.lastErrors = errs
+		}
+	}
+
+	if cpuPerPID {
+		logPerPIDUsage(c.pidReader, c.lastCPU, retired, totalDelta)
+	}
+
+	// Run-queue delay over this poll: difference of the cumulative histograms.
+	var window runqHist
+	runqOK := false
+	if runq, err := readRunqHist(c.bpf.runqMap); err == nil {
+		for i := range window {
+			window[i] = runq[i] - c.lastRunq[i]
+		}
+		c.lastRunq = runq
+		runqOK = true
+	}
+
+	// Counters since boot are not a rate.
+	if first {
+		return nil
+	}
+
+	// Calculate total CPU usage percentage across all cores.
+	percent := (float64(totalDelta) / float64(scaledIntervalNS)) * 100.0
+	r := CPUReading{
+		Percent:   percent,
+		CoreBusy:  coreBusy,
+		IdleCores: idleCores,
+		Effective: percent,
+	}
+	// Scale by clock: busy time at 600 MHz only used a quarter of a 2.4 GHz core.
+	if perCPUMHz != nil && c.freqs.known() {
+		r.Effective = min(effectiveNS/float64(scaledIntervalNS)*100.0, 100)
+		if totalDelta > 0 {
+			r.FreqRatio = effectiveNS / float64(totalDelta)
+		}
+	}
+	if runqOK {
+		r.RunqP50Us = window.percentile(0.50)
+		r.RunqP99Us = window.percentile(0.99)
+	}
+	r.TrackedPIDs = c.lastCPU.len()
+	r.HeapBytes = heapBytes()
+
+	m.UpdateCPU(r)
+	return nil
+}
+
+// cpuMapErrors mirrors 'struct map_errors' in bpf/cpu_btf.c.
+type cpuMapErrors struct {
+	UsageUpdate  uint64
+	CgroupUpdate uint64
+	WakeupUpdate uint64
+	ExitDropped  uint64
+}
+
+// readMapErrors returns the cumulative failed-update counters summed across CPUs.
+func readMapErrors(m *ebpf.Map) (cpuMapErrors, error) {
+	var key uint32 = 0
+	var perCPU []cpuMapErrors
+	var total cpuMapErrors
+	if err := m.Lookup(&key, &perCPU); err != nil {
+		return total, err
+	}
+	for _, e := range perCPU {
+		total.UsageUpdate += e.UsageUpdate
+		total.CgroupUpdate += e.CgroupUpdate
+		total.WakeupUpdate += e.WakeupUpdate
+		total.ExitDropped += e.ExitDropped
+	}
+	return total, nil
+}
+
+// runqSlots mirrors RUNQ_SLOTS in bpf/cpu_btf.c.
+const runqSlots = 32
+
+// runqHist mirrors 'struct runq_hist': slot i counts delays in [2^i, 2^(i+1)) µs.
+type runqHist [runqSlots]uint64
+
+// readRunqHist returns the cumulative run-queue histogram summed across CPUs.
+func readRunqHist(m *ebpf.Map) (runqHist, error) {
+	var key uint32 = 0
+	var perCPU []runqHist
+	var h runqHist
+	if err := m.Lookup(&key, &perCPU); err != nil {
+		return h, err
+	}
+	for _, c := range perCPU {
+		for i, v := range c {
+			h[i] += v
+		}
+	}
+	return h, nil
+}
+
+// percentile estimates the q-quantile in µs, interpolating linearly inside
+// the log2 slot that contains it. Returns 0 when no task was woken.
+func (h *runqHist) percentile(q float64) float64 {
+	var total uint64
+	for _, v := range h {
+		total += v
+	}
+	if total == 0 {
+		return 0
+	}
+	rank := q * float64(total)
+	var seen float64
+	for i, v := range h {
+		if v == 0 {
+			continue
+		}
+		if seen+float64(v) >= rank {
+			lo := float64(uint64(1) << i)
+			if i == 0 {
+				lo = 0
+			}
+			hi := float64(uint64(1) << (i + 1))
+			return lo + (hi-lo)*(rank-seen)/float64(v)
+		}
+		seen += float64(v)
+	}
+	return float64(uint64(1) << runqSlots)
+}
+
+// logPerPIDUsage is the optional detail view: it reads the per-PID map,
+// computes each PID's runtime since the previous poll and logs the top consumers.
+// retired is the runtime of exited PIDs that earlier polls had not seen yet.
+func logPerPIDUsage(reader *pidMapReader, lastCPU *pidHistory, retired retiredRuntime, busyNS uint64) {
+	type pidDelta struct {
+		pid uint32
+		ns  uint64
+	}
+	var top []pidDelta
+	entries := 0
+	var liveNS uint64
+
+	lastCPU.begin()
+	syscalls, err := reader.forEach(func(pid uint32, ns uint64) {
+		entries++
+		// If ns > prev, the process has run during this interval.
+		prev := lastCPU.observe(pid, ns)
+		if ns > prev {
+			top = append(top, pidDelta{pid: pid, ns: ns - prev})
+			liveNS += ns - prev
+		}
+	})
+	// After a partial read, unseen PIDs may still be alive: pruning them would
+	// charge their whole lifetime runtime to the next poll.
+	pruned := 0
 	if err != nil {
-		bpf.cleanup()
-		return nil, nil, fmt.Errorf("attach switch: %v", err)
+		logDebug("[CPU] per-PID read incomplete, not pruning: %v", err)
+	} else {
+		pruned = lastCPU.prune()
+	}
+	logDebug("[CPU] per-PID poll: %d PIDs, %d bpf() syscalls (%s)", entries, syscalls, reader.mode())
+	logDebug("[CPU] state: %d PIDs tracked, %d pruned, heap %.1f MiB",
+		lastCPU.len(), pruned, float64(heapBytes())/(1<<20))
+	logDebug("[CPU] accounted: live %.2f ms + exited %.2f ms (%d PIDs) of %.2f ms busy",
+		float64(liveNS)/1e6, float64(retired.ns)/1e6, retired.pids, float64(busyNS)/1e6)
+
+	sort.Slice(top, func(i, j int) bool { return top[i].ns > top[j].ns })
+	if len(top) > cpuTopN {
+		top = top[:cpuTopN]
 	}
+	for _, t := range top {
+		logDebug("  PID %-7d %8.2f ms", t.pid, float64(t.ns)/1e6)
+	}
+}
+
+// retiredRuntime is what exited PIDs ran after the previous poll saw them.
+type retiredRuntime struct {
+	pids int
+	ns   uint64
+}
+
+// exitDrainer completes the accounting of exited PIDs.
+// handle_process_exit queues the PID instead of deleting its entry, because
+// only userspace can sum the per-CPU copies. A PID is drained one poll after
+// its exit event: the task's final slice is accounted at its last switch-out,
+// which happens after the exit tracepoint.
+type exitDrainer struct {
+	rd      *ringbuf.Reader
+	m       *ebpf.Map
+	pending []uint32 // Exited during the previous poll, drained on this one
+	rec     ringbuf.Record
+	perCPU  []uint64
+}
 
-	hExit, err := link.Tracepoint("sched", "sched_process_exit", bpf.progExit, nil)
+func newExitDrainer(events, usage *ebpf.Map) (*exitDrainer, error) {
+	rd, err := ringbuf.NewReader(events)
 	if err != nil {
-		hSwitch.Close()
-		bpf.cleanup()
-		return nil, nil, fmt.Errorf("attach exit: %v", err)
+		return nil, err
 	}
+	return &exitDrainer{rd: rd, m: usage}, nil
+}
+
+// drain folds and deletes the PIDs queued on the previous poll, then queues
+// the ones that exited since. With fold unset the entries are only deleted.
+func (d *exitDrainer) drain(lastCPU *pidHistory, fold bool) retiredRuntime {
+	var r retiredRuntime
+	for _, pid := range d.pending {
+		if fold {
+			if err := d.m.Lookup(&pid, &d.perCPU); err == nil {
+				var ns uint64
+				for _, v := range d.perCPU {
+					ns += v
+				}
+				if prev := lastCPU.take(pid); ns > prev {
+					r.ns += ns - prev
+				}
+				r.pids++
+			}
+		}
+		d.m.Delete(&pid)
+	}
+	d.pending = d.pending[:0]
 
-	finalCleanup := func() {
-		hSwitch.Close()
-		hExit.Close()
-		bpf.cleanup()
+	// Non-blocking read of everything queued so far.
+	d.rd.SetDeadline(time.Now())
+	for {
+		if err := d.rd.ReadInto(&d.rec); err != nil {
+			break // os.ErrDeadlineExceeded once the ring is empty
+		}
+		if len(d.rec.RawSample) >= 4 {
+			d.pending = append(d.pending, binary.NativeEndian.Uint32(d.rec.RawSample))
+		}
 	}
+	return r
+}
 
-	// 4. Start Polling
-	out := make(chan float64)
+func (d *exitDrainer) Close() error {
+	return d.rd.Close()
+}
 
-	go pollCPUStats(out, bpf)
+// cpuBatchSize is how many PIDs a single BPF_MAP_LOOKUP_BATCH call returns.
+const cpuBatchSize = 256
 
-	return out, finalCleanup, nil
+// pidMapReader reads the per-PID cpu_usage map.
+// It prefers the kernel's batch API (one syscall per cpuBatchSize PIDs) and
+// falls back to key-by-key iteration on kernels that lack it (< 5.6).
+type pidMapReader struct {
+	m      *ebpf.Map
+	nCPU   int
+	batch  bool
+	keys   []uint32 // Reused between polls to avoid per-poll allocations
+	values []uint64 // Flattened: cpuBatchSize * nCPU per-CPU values
 }
 
-func pollCPUStats(out chan<- float64, bpf *cpuBPF) {
-	numCPUs := float64(runtime.GOMAXPROCS(0))
-	if numCPUs < 1 {
-		numCPUs = float64(runtime.NumCPU())
+func newPIDMapReader(m *ebpf.Map) *pidMapReader {
+	nCPU, err := ebpf.PossibleCPU()
+	if err != nil {
+		logDebug("[CPU] possible CPU count unavailable, batch reads disabled: %v", err)
+		return &pidMapReader{m: m}
+	}
+	return &pidMapReader{
+		m:      m,
+		nCPU:   nCPU,
+		batch:  true,
+		keys:   make([]uint32, cpuBatchSize),
+		values: make([]uint64, cpuBatchSize*nCPU),
 	}
+}
 
-	defer close(out)
-	lastCPU := make(map[uint32]uint64)
-	poll := 1 * time.Second
-	intervalNS := uint64(poll.Nanoseconds())
-	// CRITICAL: We scale the interval by the number of CPUs because the kernel
-	// accounts for CPU time per-core. 1 second of wall time on 4 cores = 4 seconds of CPU time.
-	scaledIntervalNS := uint64(float64(intervalNS) * numCPUs)
+func (r *pidMapReader) mode() string {
+	if r.batch {
+		return "batch"
+	}
+	return "iterate"
+}
+
+// forEach calls fn with every PID and its runtime summed across CPUs.
+// It returns the number of bpf() syscalls spent on the read, and an error if
+// the read stopped early: fn then saw only some of the PIDs.
+func (r *pidMapReader) forEach(fn func(pid uint32, ns uint64)) (int, error) {
+	if r.batch {
+		calls, err := r.forEachBatch(fn)
+		if err == nil {
+			return calls, nil
+		}
+		if errors.Is(err, ebpf.ErrNotSupported) && calls == 1 {
+			// Nothing was delivered yet, so it is safe to retry by iterating.
+			logDebug("[CPU] BPF_MAP_LOOKUP_BATCH not supported, falling back to iteration")
+			r.batch = false
+		} else {
+			return calls, fmt.Errorf("batch lookup: %v", err)
+		}
+	}
+	return r.forEachIter(fn)
+}
 
-	ticker := time.NewTicker(poll)
-	defer ticker.Stop()
+func (r *pidMapReader) forEachBatch(fn func(pid uint32, ns uint64)) (int, error) {
+	var cursor ebpf.MapBatchCursor
+	calls := 0
+	for {
+		n, err := r.m.BatchLookup(&cursor, r.keys, r.values, nil)
+		calls++
+		for i := 0; i < n; i++ {
+			var ns uint64
+			for _, v := range r.values[i*r.nCPU : (i+1)*r.nCPU] {
+				ns += v
+			}
+			fn(r.keys[i], ns)
+		}
+		// ErrKeyNotExist marks the end of the map, not a failure.
+		if errors.Is(err, ebpf.ErrKeyNotExist) {
+			return calls, nil
+		}
+		if err != nil {
+			return calls, err
+		}
+	}
+}
 
-	for range ticker.C {
-		var totalDelta uint64
-		var pid uint32
+func (r *pidMapReader) forEachIter(fn func(pid uint32, ns uint64)) (int, error) {
+	var pid uint32
+	var perCPU []uint64
+	entries := 0
+
+	// This map contains the cumulative CPU time (in ns) for every PID seen,
+	// split into one counter per CPU so the kernel never shares a cache line.
+	iter := r.m.Iterate()
+	for iter.Next(&pid, &perCPU) {
 		var ns uint64
+		for _, v := range perCPU {
+			ns += v
+		}
+		fn(pid, ns)
+		entries++
+	}
+	// Each entry costs a get-next-key plus a lookup; the final get-next-key ends the walk.
+	calls := 2*entries + 1
+	if err := iter.Err(); err != nil {
+		return calls, fmt.Errorf("iterate: %v", err)
+	}
+	return calls, nil
+}
 
-		// CRITICAL SECTION: Iterate over the BPF Hash Map
-		// This map contains the cumulative CPU time (in ns) for every PID seen.
-		iter := bpf.cpuMap.Iterate()
-		for iter.Next(&pid, &ns) {
-			// Calculate the CPU time consumed by this PID since the last poll.
-			// If ns > prev, the process has run during this interval.
-			prev := lastCPU[pid]
-			if ns > prev {
-				totalDelta += ns - prev
-			}
-			lastCPU[pid] = ns
+// formatCoreBusy renders per-core busy % as "12 97 3 0" for the log.
+func formatCoreBusy(cores []float64) string {
+	buf := make([]byte, 0, 4*len(cores))
+	for i, v := range cores {
+		if i > 0 {
+			buf = append(buf, ' ')
 		}
-		// Calculate total CPU usage percentage across all cores.
-		out <- (float64(totalDelta) / float64(scaledIntervalNS)) * 100.0
+		buf = strconv.AppendFloat(buf, v, 'f', 0, 64)
 	}
+	return string(buf)
 }
 
 func runCPUWatch(cmd *cobra.Command, args []string) {
-	stream, cleanup, err := StartCPUCollector()
+	var local LocalMetrics
+	cleanup, err := startCollectors(&local, func() {
+		v := local.Read()
+		logDebug("CPU: %.2f%% (effective %.2f%% at %.0f%% clock) | Idle cores: %d [%s] | Runq delay p50: %.0f µs | p99: %.0f µs | Agent: %d PIDs tracked, heap %.1f MiB\n",
+			v.CPUPercent, v.EffCPU, v.FreqRatio*100, v.IdleCores, formatCoreBusy(v.CoreBusy), v.RunqP50Us, v.RunqP99Us,
+			v.TrackedPIDs, float64(v.HeapBytes)/(1<<20))
+	}, "CPU")
 	if err != nil {
 		log.Fatal(err)
 	}
@@ -167,12 +730,5 @@ func runCPUWatch(cmd *cobra.Command, args []string) {
 	logDebug("Collecting CPU... CTRL+C to stop")
 	stop := make(chan os.Signal, 1)
 	signal.Notify(stop, syscall.SIGINT, syscall.SIGTERM)
-	for {
-		select {
-		case v := <-stream:
-			logDebug("CPU: %.2f%%\n", v)
-		case <-stop:
-			return
-		}
-	}
+	<-stop
 }
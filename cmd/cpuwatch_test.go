@@ -0,0 +1,56 @@
+package cmd
+
+import (
+	"math"
+	"testing"
+)
+
+func TestRunqHistPercentile(t *testing.T) {
+	// hist builds a histogram from slot -> count pairs.
+	hist := func(slots map[int]uint64) runqHist {
+		var h runqHist
+		for i, v := range slots {
+			h[i] = v
+		}
+		return h
+	}
+	tests := []struct {
+		name string
+		h    runqHist
+		q    float64
+		want float64
+	}{
+		{"empty", runqHist{}, 0.99, 0},
+		{"slot 0 starts at zero", hist(map[int]uint64{0: 10}), 0.5, 1},
+		{"middle of a slot", hist(map[int]uint64{3: 10}), 0.5, 12},
+		{"top of a slot", hist(map[int]uint64{3: 10}), 1, 16},
+		{"bottom of a slot", hist(map[int]uint64{3: 10}), 0, 8},
+		{"p50 in the fast mode", hist(map[int]uint64{1: 50, 10: 50}), 0.5, 4},
+		{"p99 in the slow tail", hist(map[int]uint64{1: 50, 10: 50}), 0.99, 1024 + 1024*49.0/50},
+		{"empty slots are skipped", hist(map[int]uint64{2: 1, 20: 1}), 0.75, 1<<20 + (1<<20)*0.5},
+		{"last slot", hist(map[int]uint64{runqSlots - 1: 4}), 1, 1 << runqSlots},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			if got := tt.h.percentile(tt.q); math.Abs(got-tt.want) > 1e-6 {
+				t.Errorf("percentile(%g) = %g, want %g", tt.q, got, tt.want)
+			}
+		})
+	}
+}
+
+func TestFormatCoreBusy(t *testing.T) {
+	tests := []struct {
+		in   []float64
+		want string
+	}{
+		{nil, ""},
+		{[]float64{12.4}, "12"},
+		{[]float64{0, 99.6, 3.2}, "0 100 3"},
+	}
+	for _, tt := range tests {
+		if got := formatCoreBusy(tt.in); got != tt.want {
+			t.Errorf("formatCoreBusy(%v) = %q, want %q", tt.in, got, tt.want)
+		}
+	}
+}
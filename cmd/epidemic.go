@@ -0,0 +1,249 @@
+package cmd
+
+import (
+	"math"
+	"math/rand"
+	"net"
+	"sort"
+	"strings"
+	"time"
+
+	"google.golang.org/protobuf/proto"
+
+	pb "ebpf_edge/proto"
+)
+
+// -----------------------------------------------------------------------------
+// Epidemic Gossip
+// -----------------------------------------------------------------------------
+//
+// Full-mesh gossip sends every node's state to every other node each round:
+// per-node traffic and connection count grow linearly with the cluster.
+// With --fanout k, each round a node pushes its own state to k members picked
+// at random, along with a digest of up to gossipDigestMax states it learned
+// from others. A node sends and, on average, receives k messages of bounded
+// size per round, whatever the cluster size. Digests put states relayed the
+// fewest times first, so a new version overtakes states already passed on.
+// The price of bounded traffic is staleness: a node hears of each other node
+// about every N/(k*gossipDigestMax) rounds, so nodeTTL grows with the cluster.
+//
+// Relayed states carry their node's address and age. A receiver keeps the
+// highest version of each node and takes LastSeen as now minus the age, so
+// staleness measures when the node itself was last heard of, not when the
+// rumor arrived. --peers only needs to list a few seed members; the rest of
+// the cluster is learned from the digests.
+
+// gossipDigestMax is the most third-party states relayed in one message.
+const gossipDigestMax = 16
+
+// Epidemic gossip settings, set from flags.
+var (
+	gossipFanout    int    // Members pushed to per round; 0 = every listed peer (full mesh)
+	gossipAdvertise string // Address other members reach us at
+)
+
+// gossipRand picks the targets of each round; only the main loop uses it.
+var gossipRand = rand.New(rand.NewSource(time.Now().UnixNano()))
+
+func init() {
+	peerCmd.Flags().IntVar(&gossipFanout, "fanout", 0, "Push to this many random members per round and relay what they learned (0 = full mesh over --peers)")
+	peerCmd.Flags().StringVar(&gossipAdvertise, "advertise", "", "Address announced to other members (default: the local address routed to the first peer)")
+}
+
+// resolveAdvertiseAddr returns the address other members should reach us at.
+// A UDP "dial" sends nothing; it only asks the kernel which source address
+// routes to the first peer. A node without peers (the first seed) uses its
+// first non-loopback IPv4 address.
+func resolveAdvertiseAddr() string {
+	if gossipAdvertise != "" {
+		return gossipAdvertise
+	}
+	for _, ip := range targetPeers {
+		if ip = strings.TrimSpace(ip); ip == "" {
+			continue
+		}
+		conn, err := net.Dial("udp", net.JoinHostPort(ip, PeerPort))
+		if err != nil {
+			continue
+		}
+		defer conn.Close()
+		if addr, ok := conn.LocalAddr().(*net.UDPAddr); ok {
+			return addr.IP.String()
+		}
+	}
+	addrs, _ := net.InterfaceAddrs()
+	for _, a := range addrs {
+		if ipnet, ok := a.(*net.IPNet); ok && !ipnet.IP.IsLoopback() && ipnet.IP.To4() != nil {
+			return ipnet.IP.String()
+		}
+	}
+	return ""
+}
+
+// gossipRound pushes this round's full state plus a digest to gossipFanout random members.
+// Deltas need a channel that saw every earlier version, which a random target
+// does not, so epidemic rounds always send the full state over Push.
+func gossipRound(seeds []string, update *gossipUpdate) {
+	msg, targets := globalCluster.epidemicRound(time.Now(), seeds, update.full, gossipFanout, gossipRand)
+	for _, ip := range targets {
+		go sendToPeer(ip, msg)
+	}
+}
+
+// epidemicRound builds one round's message (own state plus digest) and picks its k targets.
+func (c *ClusterState) epidemicRound(now time.Time, seeds []string, own *pb.MetricsSnapshot, k int, rnd *rand.Rand) (*pb.MetricsSnapshot, []string) {
+	msg := proto.Clone(own).(*pb.MetricsSnapshot)
+	msg.Relayed = c.digest(now, gossipDigestMax)
+	return msg, pickTargets(c.members(now, seeds), k, rnd)
+}
+
+// nodeTTL is how long a node may go unheard of before it counts as offline,
+// in a cluster of n known nodes. In full mesh every node hears from every
+// other each round. In epidemic mode a node receives about k*gossipDigestMax
+// relayed states per round, so it hears of a given node every
+// n/(k*gossipDigestMax) rounds on average. The gaps are random: across all
+// n² pairs the longest runs about 2*ln(n) times the mean, on top of the
+// log2(n) rounds a new state takes to spread.
+func nodeTTL(n int) time.Duration {
+	if gossipFanout <= 0 {
+		return NodeTTL
+	}
+	spread := math.Ceil(math.Log2(float64(n + 1)))
+	refresh := math.Ceil(float64(n) / float64(gossipFanout*gossipDigestMax))
+	tail := math.Ceil(2 * math.Log(float64(n+1)))
+	return NodeTTL + GossipInterval*time.Duration(spread+refresh*tail)
+}
+
+// expire deletes the states of nodes not heard of within nodeTTL and counts
+// the live ones. Entries were never deleted before, so nodes that came and
+// went kept inflating the TTL and rode along in digests and member sets.
+// The cut uses the TTL of the map size before it, which is not shorter than
+// the liveness TTL: an entry is gone only once no TTL would keep it.
+func (c *ClusterState) expire(now time.Time) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	ttl := nodeTTL(len(c.Metrics))
+	live := 1 // Ourselves
+	for k, d := range c.Metrics {
+		if k == "localhost" || k == c.self {
+			continue
+		}
+		if now.Sub(d.LastSeen) > ttl {
+			delete(c.Metrics, k)
+			continue
+		}
+		if state, ok := membership.state(k); !ok || state != memberDead {
+			live++
+		}
+	}
+	c.live = live
+}
+
+// liveNodes is the cluster size nodeTTL scales with, as of the last expire.
+func (c *ClusterState) liveNodes() int {
+	c.mu.RLock()
+	defer c.mu.RUnlock()
+	return c.live
+}
+
+// mergeRelayed stores a third-party state if it is newer than ours, or
+// refreshes LastSeen if it is the same version heard of more recently.
+// The caller holds c.mu.
+func (c *ClusterState) mergeRelayed(r *pb.MetricsSnapshot, now time.Time) {
+	if r.Node == "" || r.Node == c.self || r.Node == "localhost" {
+		return
+	}
+	seen := now.Add(-time.Duration(r.AgeMs) * time.Millisecond)
+	r.AgeMs = 0
+	prev, ok := c.Metrics[r.Node]
+	switch {
+	case !ok || prev.Snapshot == nil || r.Version > prev.Snapshot.Version:
+		c.Metrics[r.Node] = NodeData{Snapshot: r, LastSeen: seen}
+	case r.Version == prev.Snapshot.Version && seen.After(prev.LastSeen):
+		prev.LastSeen = seen
+		c.Metrics[r.Node] = prev
+	}
+}
+
+// digest picks up to max fresh third-party states to relay: the least relayed
+// first, so new versions spread before old ones are repeated, then the most
+// recently heard of.
+func (c *ClusterState) digest(now time.Time, max int) []*pb.MetricsSnapshot {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	ttl := nodeTTL(c.live)
+	var keys []string
+	for k, d := range c.Metrics {
+		if k != "localhost" && k != c.self && d.Snapshot != nil && now.Sub(d.LastSeen) <= ttl {
+			keys = append(keys, k)
+		}
+	}
+	sort.Slice(keys, func(i, j int) bool {
+		a, b := c.Metrics[keys[i]], c.Metrics[keys[j]]
+		if a.Relays != b.Relays {
+			return a.Relays < b.Relays
+		}
+		if !a.LastSeen.Equal(b.LastSeen) {
+			return a.LastSeen.After(b.LastSeen)
+		}
+		return keys[i] < keys[j]
+	})
+	if len(keys) > max {
+		keys = keys[:max]
+	}
+
+	out := make([]*pb.MetricsSnapshot, 0, len(keys))
+	for _, k := range keys {
+		d := c.Metrics[k]
+		r := proto.Clone(d.Snapshot).(*pb.MetricsSnapshot)
+		r.Node = k
+		r.AgeMs = uint32(now.Sub(d.LastSeen).Milliseconds())
+		out = append(out, r)
+		d.Relays++
+		c.Metrics[k] = d
+	}
+	return out
+}
+
+// members returns the seeds plus every node heard of within its TTL, excluding ourselves.
+func (c *ClusterState) members(now time.Time, seeds []string) []string {
+	c.mu.RLock()
+	defer c.mu.RUnlock()
+	ttl := nodeTTL(c.live)
+	set := make(map[string]bool, len(c.Metrics)+len(seeds))
+	for _, ip := range seeds {
+		if ip = strings.TrimSpace(ip); ip != "" {
+			set[ip] = true
+		}
+	}
+	for k, d := range c.Metrics {
+		if now.Sub(d.LastSeen) <= ttl {
+			set[k] = true
+		}
+		if state, ok := membership.state(k); ok && state == memberDead {
+			delete(set, k)
+		}
+	}
+	delete(set, "localhost")
+	delete(set, c.self)
+
+	out := make([]string, 0, len(set))
+	for k := range set {
+		out = append(out, k)
+	}
+	sort.Strings(out) // Map order would make seeded runs irreproducible
+	return out
+}
+
+// pickTargets returns k members chosen uniformly at random (all of them if
+// there are no more than k). It shuffles members in place.
+func pickTargets(members []string, k int, rnd *rand.Rand) []string {
+	if len(members) <= k {
+		return members
+	}
+	for i := 0; i < k; i++ {
+		j := i + rnd.Intn(len(members)-i)
+		members[i], members[j] = members[j], members[i]
+	}
+	return members[:k]
+}
@@ -0,0 +1,34 @@
+package cmd
+
+import (
+	"testing"
+	"time"
+)
+
+func TestNodeTTL(t *testing.T) {
+	saved := gossipFanout
+	defer func() { gossipFanout = saved }()
+
+	tests := []struct {
+		name   string
+		fanout int
+		n      int
+		want   time.Duration
+	}{
+		{"full mesh", 0, 1000, NodeTTL},
+		{"no other nodes", 3, 0, NodeTTL},
+		{"one node", 3, 1, NodeTTL + 3*GossipInterval},                      // spread + refresh*tail: 1 + 1*2 rounds
+		{"one digest round covers all", 3, 48, NodeTTL + 14*GossipInterval}, // 6 + 1*8
+		{"hundred nodes", 3, 100, NodeTTL + 37*GossipInterval},              // 7 + 3*10
+		{"hundred nodes, fanout 1", 1, 100, NodeTTL + 77*GossipInterval},    // 7 + 7*10
+		{"thousand nodes", 3, 1000, NodeTTL + 304*GossipInterval},           // 10 + 21*14
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			gossipFanout = tt.fanout
+			if got := nodeTTL(tt.n); got != tt.want {
+				t.Errorf("nodeTTL(%d) with fanout %d = %v, want %v", tt.n, tt.fanout, got, tt.want)
+			}
+		})
+	}
+}
@@ -0,0 +1,242 @@
+package cmd
+
+import (
+	"context"
+	"errors"
+	"io"
+	"sync"
+	"time"
+
+	"google.golang.org/grpc/codes"
+	"google.golang.org/grpc/status"
+
+	pb "ebpf_edge/proto"
+)
+
+// -----------------------------------------------------------------------------
+// Streaming Gossip
+// -----------------------------------------------------------------------------
+//
+// Each peer pair keeps one Gossip stream open, and both nodes send their
+// snapshots over it. One HTTP/2 stream carries both directions, so a tick
+// costs one DATA frame per peer: no request headers and no Ack round trip.
+// A stream is opened lazily by the first broadcast to a peer. A stream the
+// peer opened to us is reused, so two nodes that list each other share one.
+// A peer only dials when it holds no stream to us, so a stream it opens
+// replaces the one we hold: that one is dead, whether the peer restarted or
+// its connection died unnoticed. The exception is both nodes dialing at
+// once, where each side keeps the stream dialed by the lower address.
+// Peers that answer Unimplemented (older builds) get unary Push, and are
+// retried after gossipRetryUnsupported.
+
+// gossipRetryUnsupported is how long a peer without Gossip is served with Push
+// before the stream is tried again (it may have been upgraded).
+const gossipRetryUnsupported = 5 * time.Minute
+
+// gossipPush forces unary Push for every peer (benchmark baseline).
+var gossipPush bool
+
+func init() {
+	peerCmd.Flags().BoolVar(&gossipPush, "gossip-push", false, "Send metrics with unary Push instead of the Gossip stream")
+}
+
+// gossipStream is the part of the client and server stream types gossip uses.
+type gossipStream interface {
+	Send(*pb.MetricsSnapshot) error
+	Recv() (*pb.MetricsSnapshot, error)
+}
+
+// gossipLink is an open stream to or from one peer.
+// Its sender goroutine is the only caller of Send, as gRPC requires.
+type gossipLink struct {
+	out      chan *gossipUpdate // Latest unsent update; an older one is replaced
+	done     chan struct{}
+	replaced chan struct{} // Closed when a newer stream with the same peer takes over
+	inbound  bool          // The peer dialed it
+	opened   time.Time
+}
+
+// replacedBy reports whether a stream ip just dialed to us should take over
+// from l. If l is our own stream and still fresh, both nodes dialed at once:
+// the stream dialed by the lower address wins, on both sides alike.
+func (l *gossipLink) replacedBy(ip, self string) bool {
+	if l.inbound || self == "" || time.Since(l.opened) > GossipInterval {
+		return true
+	}
+	return ip < self
+}
+
+// offer queues an update without blocking; a slow peer only ever gets the newest one.
+// Only the broadcast loop offers, so the slot is free after the drain.
+func (l *gossipLink) offer(u *gossipUpdate) {
+	select {
+	case <-l.out:
+	default:
+	}
+	l.out <- u
+}
+
+// gossipHub tracks the open gossip streams by peer IP.
+type gossipHub struct {
+	mu          sync.Mutex
+	links       map[string]*gossipLink
+	dialing     map[string]bool
+	unsupported map[string]time.Time // Peers that answered Unimplemented, and when
+}
+
+var gossip = gossipHub{
+	links:       make(map[string]*gossipLink),
+	dialing:     make(map[string]bool),
+	unsupported: make(map[string]time.Time),
+}
+
+// broadcast offers the update to every open stream and returns the peers it reached.
+func (h *gossipHub) broadcast(u *gossipUpdate) map[string]bool {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+	reached := make(map[string]bool, len(h.links))
+	for ip, l := range h.links {
+		l.offer(u)
+		reached[ip] = true
+	}
+	return reached
+}
+
+// open starts dialing a stream to ip in the background, unless one is already
+// being dialed or ip recently answered Unimplemented.
+func (h *gossipHub) open(ip string) {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+	if since, ok := h.unsupported[ip]; ok {
+		if time.Since(since) < gossipRetryUnsupported {
+			return
+		}
+		delete(h.unsupported, ip)
+	}
+	if !h.dialing[ip] {
+		h.dialing[ip] = true
+		go h.dial(ip)
+	}
+}
+
+// dial opens a Gossip stream to ip and serves it until it breaks.
+func (h *gossipHub) dial(ip string) {
+	defer func() {
+		h.mu.Lock()
+		delete(h.dialing, ip)
+		h.mu.Unlock()
+	}()
+
+	client, err := peerConns.client(ip)
+	if err != nil {
+		return
+	}
+	ctx, cancel := context.WithCancel(context.Background())
+	defer cancel() // Resets the stream on the way out
+	stream, err := client.Gossip(ctx)
+	if err == nil {
+		err = h.serve(ip, stream, false)
+	}
+	if status.Code(err) == codes.Unimplemented {
+		logDebug("[GOSSIP] %s has no Gossip stream, using Push", ip)
+		h.mu.Lock()
+		h.unsupported[ip] = time.Now()
+		h.mu.Unlock()
+	}
+}
+
+// serve registers the stream as ip's link, feeds received snapshots into
+// globalCluster, and returns once the stream breaks or another stream with ip
+// replaces it. A stream that does not take over the link (the loser of a
+// simultaneous dial) is only read from.
+func (h *gossipHub) serve(ip string, stream gossipStream, inbound bool) error {
+	l := &gossipLink{
+		out:      make(chan *gossipUpdate, 1),
+		done:     make(chan struct{}),
+		replaced: make(chan struct{}),
+		inbound:  inbound,
+		opened:   time.Now(),
+	}
+	h.mu.Lock()
+	old, taken := h.links[ip]
+	if !taken || inbound && old.replacedBy(ip, globalCluster.self) {
+		if taken {
+			close(old.replaced)
+		}
+		h.links[ip] = l
+	}
+	h.mu.Unlock()
+
+	var sender sync.WaitGroup
+	sender.Add(1)
+	go func() {
+		defer sender.Done()
+		var lastSent uint64 // Version the peer holds; 0 = nothing yet, so the first message is full
+		for {
+			select {
+			case u := <-l.out:
+				if err := stream.Send(u.forLink(lastSent)); err != nil {
+					return // Recv reports the stream's status
+				}
+				lastSent = u.version
+			case <-l.done:
+				return
+			}
+		}
+	}()
+
+	// Recv runs apart, so a replaced link can return without waiting to hear
+	// from a peer that may be gone. Returning ends the stream, which unblocks it.
+	// A delta or heartbeat we cannot apply also ends it: the peer's side of
+	// the link would keep building on the version it thinks we hold, so both
+	// start over, and the redialed stream opens with a full state.
+	recvErr := make(chan error, 1)
+	go func() {
+		key := ip     // A full state naming its node keys the deltas and heartbeats after it
+		fresh := true // Until the stream's first full state: that one is authoritative
+		for {
+			snap, err := stream.Recv()
+			if err != nil {
+				recvErr <- err
+				return
+			}
+			if snap.Node != "" {
+				key = snap.Node
+			}
+			full := snap.BaseVersion == 0 && !snap.Heartbeat
+			err = globalCluster.Apply(key, snap, fresh && full)
+			if full {
+				fresh = false
+			}
+			if errors.Is(err, errGossipBase) {
+				logDebug("[GOSSIP] %s: version %d (base %d) not applicable, resyncing", key, snap.Version, snap.BaseVersion)
+				recvErr <- status.Errorf(codes.FailedPrecondition, "gossip %s: %v", key, err)
+				return
+			}
+			if err != nil {
+				logDebug("[GOSSIP] %s: dropped version %d: %v", key, snap.Version, err)
+			}
+		}
+	}()
+
+	var err error
+	select {
+	case err = <-recvErr:
+	case <-l.replaced:
+		logDebug("[GOSSIP] %s: stream replaced by a newer one", ip)
+		err = status.Error(codes.Aborted, "replaced by a newer gossip stream")
+	}
+
+	h.mu.Lock()
+	if h.links[ip] == l {
+		delete(h.links, ip)
+	}
+	h.mu.Unlock()
+	close(l.done)
+	// A server handler must not return while Send may still be called.
+	sender.Wait()
+	if errors.Is(err, io.EOF) {
+		return nil
+	}
+	return err
+}
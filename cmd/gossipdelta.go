@@ -0,0 +1,248 @@
+package cmd
+
+import (
+	"errors"
+	"math"
+	"time"
+
+	"google.golang.org/protobuf/proto"
+	"google.golang.org/protobuf/reflect/protoreflect"
+
+	pb "ebpf_edge/proto"
+)
+
+// -----------------------------------------------------------------------------
+// Change Suppression & Delta Encoding
+// -----------------------------------------------------------------------------
+//
+// Most ticks, CPU, memory and temperature move by a fraction of a percent.
+// The encoder keeps the last state it announced and only announces a field
+// again once it moves past its deadband. Each announcement bumps the node's
+// version and yields a delta carrying just the moved fields. A tick where
+// nothing moved yields a heartbeat: the version alone, under ten bytes.
+//
+// Deltas only work over an ordered, lossless channel that has seen every
+// earlier version, which a gossip stream is. Each stream starts with a full
+// snapshot and tracks the version it last sent. Unary Push always sends
+// the full announced state.
+
+// Deadbands, set from flags.
+var (
+	gossipDeadbandPct   float64 // Percentage points, for utilization and pressure fields
+	gossipDeadbandTempC float64 // °C, for temperatures
+)
+
+// gossipDeadbandRel is the relative change that resends latency, stall and
+// time-to-WARM figures. They span orders of magnitude, and the scheduler only
+// compares them against limits far apart from their normal values.
+const gossipDeadbandRel = 0.25
+
+// gossipMetricFields is the mask of MetricsSnapshot field numbers that carry
+// metrics: 1-19, and cores (28), added after the control fields.
+const gossipMetricFields uint64 = 1<<20 - 2 | 1<<28
+
+func init() {
+	peerCmd.Flags().Float64Var(&gossipDeadbandPct, "deadband", 2.0, "Resend a utilization/pressure metric only after it moves this many percentage points")
+	peerCmd.Flags().Float64Var(&gossipDeadbandTempC, "deadband-temp", 0.5, "Resend a temperature only after it moves this many °C")
+}
+
+// gossipUpdate is one tick's announcement, shared read-only by every link.
+type gossipUpdate struct {
+	version   uint64
+	full      *pb.MetricsSnapshot // Announced state at version
+	delta     *pb.MetricsSnapshot // From version-1 to version; nil if nothing moved this tick
+	heartbeat *pb.MetricsSnapshot
+}
+
+// forLink picks the smallest message for a link that last sent lastSent.
+func (u *gossipUpdate) forLink(lastSent uint64) *pb.MetricsSnapshot {
+	switch {
+	case lastSent == u.version:
+		return u.heartbeat
+	case u.delta != nil && lastSent == u.version-1:
+		return u.delta
+	default:
+		return u.full
+	}
+}
+
+// gossipEncoder turns every tick's snapshot into an update.
+// Only the main loop calls next.
+type gossipEncoder struct {
+	version   uint64
+	announced *pb.MetricsSnapshot
+}
+
+func (e *gossipEncoder) next(cur *pb.MetricsSnapshot) *gossipUpdate {
+	first := e.announced == nil
+	var changed uint64
+	if first {
+		// Versions start at the wall clock in ms, so a restarted node's
+		// states supersede what peers still relay from its previous run.
+		e.version = uint64(time.Now().UnixMilli())
+		e.announced = &pb.MetricsSnapshot{}
+		changed = ^uint64(0)
+	} else {
+		changed = movedFields(e.announced, cur)
+	}
+
+	if changed != 0 {
+		// Copy-on-write: links may still be sending the previous state.
+		next := proto.Clone(e.announced).(*pb.MetricsSnapshot)
+		copyFields(next, cur, changed)
+		e.version++
+		next.Version = e.version
+		next.Node = cur.Node
+		e.announced = next
+	}
+	u := &gossipUpdate{
+		version:   e.version,
+		full:      e.announced,
+		heartbeat: &pb.MetricsSnapshot{Version: e.version, Heartbeat: true},
+	}
+	if changed != 0 && !first {
+		u.delta = &pb.MetricsSnapshot{Version: e.version, BaseVersion: e.version - 1, Changed: changed}
+		copyFields(u.delta, cur, changed)
+	}
+	return u
+}
+
+// movedFields returns the mask of fields in cur that moved past their deadband since ref.
+func movedFields(ref, cur *pb.MetricsSnapshot) uint64 {
+	var mask uint64
+	mark := func(field int, moved bool) {
+		if moved {
+			mask |= 1 << field
+		}
+	}
+	pct, temp := gossipDeadbandPct, gossipDeadbandTempC
+
+	mark(1, math.Abs(cur.Cpu-ref.Cpu) >= pct)
+	mark(2, math.Abs(cur.Mem-ref.Mem) >= pct)
+	mark(3, math.Abs(cur.TempC-ref.TempC) >= temp)
+	mark(4, cur.TempStatus != ref.TempStatus)
+	mark(5, cur.Zone != ref.Zone)
+	mark(6, cur.Hardware != ref.Hardware)
+	mark(7, zonesMoved(ref.Zones, cur.Zones, temp))
+	mark(8, relMoved(ref.SecsToWarm, cur.SecsToWarm))
+	mark(9, relMoved(ref.MemStallMs, cur.MemStallMs))
+	mark(10, cur.OomKills != ref.OomKills)
+	mark(11, pressureMoved(ref.CpuPressure, cur.CpuPressure, pct))
+	mark(12, pressureMoved(ref.MemPressure, cur.MemPressure, pct))
+	mark(13, pressureMoved(ref.IoPressure, cur.IoPressure, pct))
+	mark(14, relMoved(ref.RunqP50Us, cur.RunqP50Us))
+	mark(15, relMoved(ref.RunqP99Us, cur.RunqP99Us))
+	mark(16, coresMoved(ref.CoreBusy, cur.CoreBusy, pct))
+	mark(17, cur.IdleCores != ref.IdleCores)
+	mark(18, math.Abs(cur.EffCpu-ref.EffCpu) >= pct)
+	mark(19, math.Abs(cur.FreqRatio-ref.FreqRatio)*100 >= pct)
+	mark(28, cur.Cores != ref.Cores)
+	return mask
+}
+
+// relMoved reports a relative change past gossipDeadbandRel, or a change to or from zero.
+func relMoved(ref, cur float64) bool {
+	if ref == 0 || cur == 0 {
+		return ref != cur
+	}
+	return math.Abs(cur-ref) >= gossipDeadbandRel*math.Abs(ref)
+}
+
+func zonesMoved(ref, cur []*pb.ThermalZone, temp float64) bool {
+	if len(ref) != len(cur) {
+		return true
+	}
+	for i := range cur {
+		if cur[i].Id != ref[i].Id || cur[i].Name != ref[i].Name ||
+			math.Abs(cur[i].TempC-ref[i].TempC) >= temp || relMoved(ref[i].SecsToWarm, cur[i].SecsToWarm) {
+			return true
+		}
+	}
+	return false
+}
+
+func coresMoved(ref, cur []float32, pct float64) bool {
+	if len(ref) != len(cur) {
+		return true
+	}
+	for i := range cur {
+		if math.Abs(float64(cur[i]-ref[i])) >= pct {
+			return true
+		}
+	}
+	return false
+}
+
+// pressureMoved compares the avg10 shares; the cumulative totals always grow
+// and are only refreshed along with them.
+func pressureMoved(ref, cur *pb.Pressure, pct float64) bool {
+	if (ref == nil) != (cur == nil) {
+		return true
+	}
+	if cur == nil {
+		return false
+	}
+	return math.Abs(cur.SomeAvg10-ref.SomeAvg10) >= pct ||
+		math.Abs(cur.FullAvg10-ref.FullAvg10) >= pct
+}
+
+// copyFields sets the masked metric fields of dst to their values in src.
+// Repeated and message values are shared, not copied: snapshots are never mutated once built.
+func copyFields(dst, src *pb.MetricsSnapshot, mask uint64) {
+	d, s := dst.ProtoReflect(), src.ProtoReflect()
+	fields := d.Descriptor().Fields()
+	for n := 1; n < 64; n++ {
+		if mask&gossipMetricFields&(1<<n) == 0 {
+			continue
+		}
+		fd := fields.ByNumber(protoreflect.FieldNumber(n))
+		if fd == nil {
+			continue
+		}
+		if s.Has(fd) {
+			d.Set(fd, s.Get(fd))
+		} else {
+			d.Clear(fd)
+		}
+	}
+}
+
+// Why applyGossip turned a message down.
+var (
+	// errGossipBase: a delta or heartbeat refers to a version we do not hold.
+	// The sending link believes we are current, so every later delta and
+	// heartbeat on it fails too: the stream must restart with a full state.
+	errGossipBase = errors.New("base version not held")
+
+	// errGossipStale: a full state older than the one we hold arrived out of
+	// order (a late Push or relay). Taking it would roll the state back.
+	errGossipStale = errors.New("older than the state held")
+)
+
+// applyGossip folds a received message into the sender's last known state.
+// It returns the new state, or prev and the reason the message was turned down.
+// fresh marks the first full state of a new stream from the node itself. That
+// is the node's current state whatever its version: versions start at the
+// wall clock, and a node whose clock was set back at boot (no RTC, no NTP yet)
+// restarts below what peers hold. Only other full states are version ordered.
+func applyGossip(prev, msg *pb.MetricsSnapshot, fresh bool) (*pb.MetricsSnapshot, error) {
+	switch {
+	case msg.Heartbeat:
+		if prev == nil || prev.Version != msg.Version {
+			return prev, errGossipBase
+		}
+		return prev, nil
+	case msg.BaseVersion != 0:
+		if prev == nil || prev.Version != msg.BaseVersion {
+			return prev, errGossipBase
+		}
+		next := proto.Clone(prev).(*pb.MetricsSnapshot)
+		copyFields(next, msg, msg.Changed)
+		next.Version = msg.Version
+		return next, nil
+	case !fresh && prev != nil && msg.Version < prev.Version:
+		return prev, errGossipStale
+	default:
+		return msg, nil
+	}
+}
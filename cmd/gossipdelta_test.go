@@ -0,0 +1,170 @@
+package cmd
+
+import (
+	"errors"
+	"testing"
+
+	"google.golang.org/protobuf/proto"
+
+	pb "ebpf_edge/proto"
+)
+
+func TestApplyGossip(t *testing.T) {
+	held := &pb.MetricsSnapshot{Version: 100, Cpu: 40, Mem: 60, TempStatus: "SAFE"}
+	tests := []struct {
+		name    string
+		prev    *pb.MetricsSnapshot
+		msg     *pb.MetricsSnapshot
+		fresh   bool
+		want    *pb.MetricsSnapshot
+		wantErr error
+	}{
+		{
+			name: "first full state",
+			msg:  &pb.MetricsSnapshot{Version: 100, Cpu: 40},
+			want: &pb.MetricsSnapshot{Version: 100, Cpu: 40},
+		},
+		{
+			name: "newer full state",
+			prev: held,
+			msg:  &pb.MetricsSnapshot{Version: 150, Cpu: 10},
+			want: &pb.MetricsSnapshot{Version: 150, Cpu: 10},
+		},
+		{
+			name: "same full state again",
+			prev: held,
+			msg:  &pb.MetricsSnapshot{Version: 100, Cpu: 40, Mem: 60, TempStatus: "SAFE"},
+			want: held,
+		},
+		{
+			name:    "older full state",
+			prev:    held,
+			msg:     &pb.MetricsSnapshot{Version: 99, Cpu: 90},
+			want:    held,
+			wantErr: errGossipStale,
+		},
+		{
+			name:  "older full state opening a stream", // The node's clock was set back
+			prev:  held,
+			msg:   &pb.MetricsSnapshot{Version: 99, Cpu: 90},
+			fresh: true,
+			want:  &pb.MetricsSnapshot{Version: 99, Cpu: 90},
+		},
+		{
+			name: "delta on the held version",
+			prev: held,
+			msg: &pb.MetricsSnapshot{Version: 101, BaseVersion: 100, Cpu: 55,
+				Changed: 1<<1 | 1<<4}, // TempStatus unset: cleared
+			want: &pb.MetricsSnapshot{Version: 101, Cpu: 55, Mem: 60},
+		},
+		{
+			name:    "delta on another version",
+			prev:    held,
+			fresh:   true, // Only full states are authoritative
+			msg:     &pb.MetricsSnapshot{Version: 102, BaseVersion: 101, Cpu: 55, Changed: 1 << 1},
+			want:    held,
+			wantErr: errGossipBase,
+		},
+		{
+			name:    "delta without a state",
+			msg:     &pb.MetricsSnapshot{Version: 101, BaseVersion: 100, Changed: 1 << 1},
+			wantErr: errGossipBase,
+		},
+		{
+			name: "heartbeat on the held version",
+			prev: held,
+			msg:  &pb.MetricsSnapshot{Version: 100, Heartbeat: true},
+			want: held,
+		},
+		{
+			name:    "heartbeat on another version",
+			prev:    held,
+			msg:     &pb.MetricsSnapshot{Version: 101, Heartbeat: true},
+			want:    held,
+			wantErr: errGossipBase,
+		},
+		{
+			name:    "heartbeat without a state",
+			msg:     &pb.MetricsSnapshot{Version: 100, Heartbeat: true},
+			wantErr: errGossipBase,
+		},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			before := proto.Clone(held)
+			got, err := applyGossip(tt.prev, tt.msg, tt.fresh)
+			if !errors.Is(err, tt.wantErr) {
+				t.Fatalf("err = %v, want %v", err, tt.wantErr)
+			}
+			if !proto.Equal(got, tt.want) {
+				t.Errorf("state = %v, want %v", got, tt.want)
+			}
+			if !proto.Equal(held, before) {
+				t.Errorf("held state mutated to %v", held)
+			}
+		})
+	}
+}
+
+func TestMovedFields(t *testing.T) {
+	savedPct, savedTemp := gossipDeadbandPct, gossipDeadbandTempC
+	gossipDeadbandPct, gossipDeadbandTempC = 2, 0.5
+	defer func() { gossipDeadbandPct, gossipDeadbandTempC = savedPct, savedTemp }()
+
+	ref := &pb.MetricsSnapshot{
+		Cpu:         40,
+		TempC:       50,
+		TempStatus:  "SAFE",
+		Zones:       []*pb.ThermalZone{{Id: 1, Name: "cpu", TempC: 50, SecsToWarm: 100}},
+		RunqP99Us:   200,
+		CpuPressure: &pb.Pressure{SomeAvg10: 5, SomeTotalUs: 1000},
+		CoreBusy:    []float32{10, 20},
+		FreqRatio:   0.80,
+	}
+	tests := []struct {
+		name   string
+		modify func(cur *pb.MetricsSnapshot)
+		want   uint64
+	}{
+		{"unchanged", func(cur *pb.MetricsSnapshot) {}, 0},
+		{"cpu within deadband", func(cur *pb.MetricsSnapshot) { cur.Cpu = 41.9 }, 0},
+		{"cpu past deadband", func(cur *pb.MetricsSnapshot) { cur.Cpu = 42 }, 1 << 1},
+		{"temperature past deadband", func(cur *pb.MetricsSnapshot) { cur.TempC = 49.5 }, 1 << 3},
+		{"status", func(cur *pb.MetricsSnapshot) { cur.TempStatus = "WARM" }, 1 << 4},
+		{"zone temperature", func(cur *pb.MetricsSnapshot) {
+			cur.Zones = []*pb.ThermalZone{{Id: 1, Name: "cpu", TempC: 50.5, SecsToWarm: 100}}
+		}, 1 << 7},
+		{"zone time-to-WARM within 25%", func(cur *pb.MetricsSnapshot) {
+			cur.Zones = []*pb.ThermalZone{{Id: 1, Name: "cpu", TempC: 50, SecsToWarm: 80}}
+		}, 0},
+		{"zone stops heating", func(cur *pb.MetricsSnapshot) {
+			cur.Zones = []*pb.ThermalZone{{Id: 1, Name: "cpu", TempC: 50}}
+		}, 1 << 7},
+		{"zone added", func(cur *pb.MetricsSnapshot) {
+			cur.Zones = append(cur.Zones, &pb.ThermalZone{Id: 2, Name: "gpu"})
+		}, 1 << 7},
+		{"time-to-WARM from zero", func(cur *pb.MetricsSnapshot) { cur.SecsToWarm = 600 }, 1 << 8},
+		{"latency within 25%", func(cur *pb.MetricsSnapshot) { cur.RunqP99Us = 249 }, 0},
+		{"latency past 25%", func(cur *pb.MetricsSnapshot) { cur.RunqP99Us = 250 }, 1 << 15},
+		{"pressure total only", func(cur *pb.MetricsSnapshot) {
+			cur.CpuPressure = &pb.Pressure{SomeAvg10: 5, SomeTotalUs: 5000}
+		}, 0},
+		{"pressure gone", func(cur *pb.MetricsSnapshot) { cur.CpuPressure = nil }, 1 << 11},
+		{"one core past deadband", func(cur *pb.MetricsSnapshot) { cur.CoreBusy = []float32{10, 23} }, 1 << 16},
+		{"clock ratio in points", func(cur *pb.MetricsSnapshot) { cur.FreqRatio = 0.77 }, 1 << 19},
+		{"several fields", func(cur *pb.MetricsSnapshot) {
+			cur.Cpu = 60
+			cur.OomKills = 1
+			cur.IdleCores = 3
+		}, 1<<1 | 1<<10 | 1<<17},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			cur := proto.Clone(ref).(*pb.MetricsSnapshot)
+			tt.modify(cur)
+			if got := movedFields(ref, cur); got != tt.want {
+				t.Errorf("movedFields = %#x, want %#x", got, tt.want)
+			}
+		})
+	}
+}
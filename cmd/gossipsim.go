@@ -0,0 +1,272 @@
+package cmd
+
+import (
+	"fmt"
+	"math"
+	"math/rand"
+	"time"
+
+	"github.com/spf13/cobra"
+	"google.golang.org/protobuf/proto"
+
+	pb "ebpf_edge/proto"
+)
+
+// -----------------------------------------------------------------------------
+// Epidemic Gossip Simulator
+// -----------------------------------------------------------------------------
+//
+// gossipsim runs clusters of in-process nodes through the code the peer uses
+// for epidemic gossip (encoder, digest, target choice, Apply) on a virtual
+// clock, with every message marshaled as it would go on the wire. Each node
+// starts out knowing only node 0, its seed. For every cluster size it reports:
+//   - rounds until every node holds a fresh state of every other one
+//   - rounds for a state change on one node to reach every other node
+//   - bytes each node sends per round, next to what full-mesh Push would send
+//   - the mean and oldest age of the entries nodes hold at the end, next to the offline TTL
+
+// Simulator settings, set from flags.
+var (
+	simSizes  []int
+	simFanout int
+	simRounds int
+	simSeed   int64
+)
+
+var gossipsimCmd = &cobra.Command{
+	Use:   "gossipsim",
+	Short: "Simulate epidemic gossip in-process: convergence time and traffic against cluster size",
+	Run:   runGossipSim,
+}
+
+func init() {
+	rootCmd.AddCommand(gossipsimCmd)
+	gossipsimCmd.Flags().IntSliceVar(&simSizes, "sizes", []int{5, 10, 25, 50, 100, 200}, "Cluster sizes to simulate")
+	gossipsimCmd.Flags().IntVar(&simFanout, "fanout", 3, "Members each node pushes to per round")
+	gossipsimCmd.Flags().IntVar(&simRounds, "rounds", 200, "Gossip rounds per cluster size")
+	gossipsimCmd.Flags().Int64Var(&simSeed, "seed", 1, "Random seed for targets and metric walks")
+}
+
+// simNode is one simulated peer.
+type simNode struct {
+	addr    string
+	cluster *ClusterState
+	encoder gossipEncoder
+	state   *pb.MetricsSnapshot
+}
+
+// simDelivery is one message in flight during a round.
+type simDelivery struct {
+	to   int
+	from string
+	wire []byte
+}
+
+// simResult is what one cluster size measured. Round counts are -1 if it never happened.
+type simResult struct {
+	converged int           // Rounds until every node held a fresh state of every other
+	spread    int           // Rounds for the changed state to reach every node
+	sentAvg   float64       // Bytes sent per node per round
+	sentMax   int           // Most bytes any node sent in one round
+	meshAvg   float64       // Bytes per node per round if each pushed its full state to all others
+	meanAge   time.Duration // Mean age of the entries in every node's view after the last round
+	maxAge    time.Duration // Oldest entry in any node's view after the last round
+	ttl       time.Duration // nodeTTL for this cluster size
+}
+
+func runGossipSim(cmd *cobra.Command, args []string) {
+	if simFanout < 1 || simRounds < 2 {
+		fmt.Println("--fanout must be at least 1 and --rounds at least 2")
+		return
+	}
+	// nodeTTL and the digest read the peer's setting.
+	gossipFanout = simFanout
+
+	fmt.Printf("Epidemic gossip: fanout %d, digest %d, %d rounds of %s, seed %d\n\n",
+		simFanout, gossipDigestMax, simRounds, GossipInterval, simSeed)
+	fmt.Printf("%6s | %14s | %14s | %12s | %10s | %14s | %8s | %8s | %8s\n",
+		"Nodes", "Converged", "Update spread", "Sent B/round", "Max B", "Full mesh B", "Mean age", "Max age", "TTL")
+	fmt.Println("--------------------------------------------------------------------------------------------------------------------")
+	for _, n := range simSizes {
+		if n < 2 {
+			continue
+		}
+		r := simulateCluster(n, rand.New(rand.NewSource(simSeed)))
+		fmt.Printf("%6d | %14s | %14s | %12.0f | %10d | %14.0f | %7.0fs | %7.0fs | %7.0fs\n",
+			n, simRoundsStr(r.converged), simRoundsStr(r.spread), r.sentAvg, r.sentMax, r.meshAvg,
+			r.meanAge.Seconds(), r.maxAge.Seconds(), r.ttl.Seconds())
+	}
+	fmt.Println("\nSent B/round is per node and should stay flat as the cluster grows; Full mesh B grows with it.")
+}
+
+func simRoundsStr(rounds int) string {
+	if rounds < 0 {
+		return "never"
+	}
+	return fmt.Sprintf("%d (%.0fs)", rounds, (time.Duration(rounds) * GossipInterval).Seconds())
+}
+
+// simulateCluster runs simRounds synchronous rounds over n nodes. Halfway
+// through, the last node's CPU jumps, and the rounds until every node holds
+// that version are counted.
+func simulateCluster(n int, rnd *rand.Rand) simResult {
+	t0 := time.Now()
+	nodes := make([]*simNode, n)
+	index := make(map[string]int, n)
+	for i := range nodes {
+		addr := fmt.Sprintf("10.0.%d.%d", i/250, i%250+1)
+		nodes[i] = &simNode{
+			addr:    addr,
+			cluster: &ClusterState{Metrics: make(map[string]NodeData), self: addr},
+		}
+		index[addr] = i
+	}
+	seeds := []string{nodes[0].addr}
+	changer, changeAt := nodes[n-1], simRounds/2
+	var changedVersion uint64
+
+	res := simResult{converged: -1, spread: -1, ttl: nodeTTL(n)}
+	var sent, mesh int
+	var now time.Time
+	for round := 0; round < simRounds; round++ {
+		now = t0.Add(time.Duration(round) * GossipInterval)
+
+		var inFlight []simDelivery
+		for _, nd := range nodes {
+			nd.state = simSample(nd.state, rnd)
+			if nd == changer && round == changeAt {
+				nd.state.Cpu = math.Mod(nd.state.Cpu+50, 100)
+			}
+			nd.state.Node = nd.addr
+			nd.cluster.Metrics["localhost"] = NodeData{Snapshot: nd.state, LastSeen: now}
+
+			update := nd.encoder.next(nd.state)
+			if nd == changer && round == changeAt {
+				changedVersion = update.version
+			}
+			msg, targets := nd.cluster.epidemicRound(now, seeds, update.full, simFanout, rnd)
+			wire, err := proto.Marshal(msg)
+			if err != nil {
+				panic(err)
+			}
+			sent += len(wire) * len(targets)
+			res.sentMax = max(res.sentMax, len(wire)*len(targets))
+			mesh += proto.Size(update.full) * (n - 1)
+			for _, ip := range targets {
+				inFlight = append(inFlight, simDelivery{to: index[ip], from: nd.addr, wire: wire})
+			}
+		}
+
+		// Every message of a round arrives before the next round starts.
+		for _, d := range inFlight {
+			msg := &pb.MetricsSnapshot{}
+			if err := proto.Unmarshal(d.wire, msg); err != nil {
+				panic(err)
+			}
+			nodes[d.to].cluster.applyAt(d.from, msg, false, now)
+		}
+		for _, nd := range nodes {
+			nd.cluster.expire(now)
+		}
+
+		if res.converged < 0 && simConverged(nodes, now) {
+			res.converged = round + 1
+		}
+		if res.spread < 0 && round >= changeAt && simHolds(nodes, changer.addr, changedVersion) {
+			res.spread = round - changeAt + 1
+		}
+	}
+
+	res.sentAvg = float64(sent) / float64(n*simRounds)
+	res.meshAvg = float64(mesh) / float64(n*simRounds)
+	var ages time.Duration
+	var entries int
+	for _, nd := range nodes {
+		for k, d := range nd.cluster.Metrics {
+			if k != "localhost" {
+				ages += now.Sub(d.LastSeen)
+				entries++
+				res.maxAge = max(res.maxAge, now.Sub(d.LastSeen))
+			}
+		}
+	}
+	if entries > 0 {
+		res.meanAge = ages / time.Duration(entries)
+	}
+	return res
+}
+
+// simConverged reports whether every node holds a fresh state of every other one.
+func simConverged(nodes []*simNode, now time.Time) bool {
+	for _, nd := range nodes {
+		ttl := nodeTTL(nd.cluster.live)
+		for _, other := range nodes {
+			if other == nd {
+				continue
+			}
+			d, ok := nd.cluster.Metrics[other.addr]
+			if !ok || now.Sub(d.LastSeen) > ttl {
+				return false
+			}
+		}
+	}
+	return true
+}
+
+// simHolds reports whether every other node holds addr's state at version or later.
+func simHolds(nodes []*simNode, addr string, version uint64) bool {
+	for _, nd := range nodes {
+		if nd.addr == addr {
+			continue
+		}
+		d, ok := nd.cluster.Metrics[addr]
+		if !ok || d.Snapshot.Version < version {
+			return false
+		}
+	}
+	return true
+}
+
+// simSample returns the next reading of a simulated node: a random walk
+// around the previous one, shaped like a real snapshot (4 cores, one zone, PSI).
+// It builds a new snapshot every time; the encoder shares fields of the old one.
+func simSample(prev *pb.MetricsSnapshot, rnd *rand.Rand) *pb.MetricsSnapshot {
+	walk := func(v, step, lo, hi float64) float64 {
+		return min(max(v+(rnd.Float64()*2-1)*step, lo), hi)
+	}
+	cpu, mem, temp := 20+rnd.Float64()*40, 30+rnd.Float64()*30, 45+rnd.Float64()*10
+	if prev != nil {
+		cpu, mem, temp = prev.Cpu, prev.Mem, prev.TempC
+	}
+	cpu, mem, temp = walk(cpu, 3, 0, 100), walk(mem, 1, 0, 100), walk(temp, 0.4, 20, 90)
+
+	cores := make([]float32, 4)
+	idle := uint32(0)
+	for i := range cores {
+		cores[i] = float32(walk(cpu, 15, 0, 100))
+		if cores[i] < coreIdlePercent {
+			idle++
+		}
+	}
+	pressure := func(avg float64) *pb.Pressure {
+		return &pb.Pressure{SomeAvg10: avg, FullAvg10: avg / 4}
+	}
+	return &pb.MetricsSnapshot{
+		Cpu:         cpu,
+		Mem:         mem,
+		TempC:       temp,
+		TempStatus:  "SAFE",
+		Zone:        "cpu-thermal",
+		Zones:       []*pb.ThermalZone{{Id: 0, Name: "cpu-thermal", TempC: temp}},
+		RunqP50Us:   walk(40, 20, 1, 1000),
+		RunqP99Us:   walk(400, 200, 10, 10000),
+		CpuPressure: pressure(cpu / 10),
+		MemPressure: pressure(0),
+		IoPressure:  pressure(walk(1, 1, 0, 100)),
+		CoreBusy:    cores,
+		IdleCores:   idle,
+		EffCpu:      cpu * 0.8,
+		FreqRatio:   0.8,
+		Cores:       uint32(len(cores)),
+	}
+}
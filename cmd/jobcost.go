@@ -0,0 +1,136 @@
+package cmd
+
+import (
+	"bufio"
+	"fmt"
+	"os"
+	"strings"
+	"sync"
+	"syscall"
+	"time"
+)
+
+// -----------------------------------------------------------------------------
+// Per-Job CPU Cost
+// -----------------------------------------------------------------------------
+//
+// The CPU programs also account runtime per cgroup id. Every container Docker
+// starts gets its own cgroup, so the runtime of a job is the growth of its
+// cgroup's counter between start and exit. No Docker stats API polling needed.
+
+// jobCostAlpha weights the newest measurement in the per-job moving average.
+const jobCostAlpha = 0.3
+
+// cgroupRoot is where the unified (v2) hierarchy is mounted.
+// bpf_get_current_cgroup_id() returns the inode number of a directory below it.
+const cgroupRoot = "/sys/fs/cgroup"
+
+// containerCgroupID resolves the cgroup v2 id of a running container from its init PID.
+func containerCgroupID(pid int) (uint64, error) {
+	f, err := os.Open(fmt.Sprintf("/proc/%d/cgroup", pid))
+	if err != nil {
+		return 0, err
+	}
+	defer f.Close()
+
+	// The unified hierarchy is the "0::<path>" line.
+	scanner := bufio.NewScanner(f)
+	for scanner.Scan() {
+		path, ok := strings.CutPrefix(scanner.Text(), "0::")
+		if !ok {
+			continue
+		}
+		var st syscall.Stat_t
+		if err := syscall.Stat(cgroupRoot+path, &st); err != nil {
+			return 0, err
+		}
+		return st.Ino, nil
+	}
+	return 0, fmt.Errorf("pid %d has no cgroup v2 entry (cgroup v1 host?)", pid)
+}
+
+// trackedContainer is a job container whose cgroup is being accounted.
+type trackedContainer struct {
+	ContainerID string
+	Job         string
+	Started     time.Time // Just before ContainerStart
+}
+
+// containerTracker maps cgroup ids to the containers started by executeDockerContainer.
+type containerTracker struct {
+	mu         sync.Mutex
+	containers map[uint64]trackedContainer
+}
+
+var localContainers = containerTracker{
+	containers: make(map[uint64]trackedContainer),
+}
+
+// start begins accounting a container started at started. The cgroup can only
+// be resolved once the container runs, but the start itself creates it, so its
+// whole counter belongs to the job: nothing burned before tracking began is lost.
+func (t *containerTracker) start(cgroupID uint64, containerID, job string, started time.Time) error {
+	if _, err := cgroupRuntimeNS(cgroupID); err != nil {
+		return err
+	}
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	t.containers[cgroupID] = trackedContainer{
+		ContainerID: containerID,
+		Job:         job,
+		Started:     started,
+	}
+	return nil
+}
+
+// finish stops accounting and returns the container's average CPU use over
+// its lifetime in cores (CPU-seconds per wall second). Unlike a share of this
+// node, that means the same on every board.
+func (t *containerTracker) finish(cgroupID uint64) (trackedContainer, float64, error) {
+	t.mu.Lock()
+	c, ok := t.containers[cgroupID]
+	delete(t.containers, cgroupID)
+	t.mu.Unlock()
+	if !ok {
+		return c, 0, fmt.Errorf("cgroup %d not tracked", cgroupID)
+	}
+
+	endNS, err := cgroupRuntimeNS(cgroupID)
+	if err != nil {
+		return c, 0, err
+	}
+	wall := time.Since(c.Started)
+	if wall <= 0 || endNS == 0 {
+		return c, 0, fmt.Errorf("no runtime recorded for cgroup %d", cgroupID)
+	}
+	return c, float64(endNS) / float64(wall.Nanoseconds()), nil
+}
+
+// jobCostModel keeps a moving average of measured CPU cost per job name, in cores.
+type jobCostModel struct {
+	mu   sync.Mutex
+	cost map[string]float64
+}
+
+var jobCosts = jobCostModel{
+	cost: make(map[string]float64),
+}
+
+func (j *jobCostModel) observe(job string, cores float64) {
+	j.mu.Lock()
+	defer j.mu.Unlock()
+	prev, ok := j.cost[job]
+	if !ok {
+		j.cost[job] = cores
+		return
+	}
+	j.cost[job] = jobCostAlpha*cores + (1-jobCostAlpha)*prev
+}
+
+// estimate returns the learned cost in cores for a job name, if it has run here before.
+func (j *jobCostModel) estimate(job string) (float64, bool) {
+	j.mu.Lock()
+	defer j.mu.Unlock()
+	v, ok := j.cost[job]
+	return v, ok
+}
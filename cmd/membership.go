@@ -0,0 +1,520 @@
+package cmd
+
+import (
+	"context"
+	"math"
+	"math/rand"
+	"sort"
+	"strings"
+	"sync"
+	"time"
+
+	"google.golang.org/grpc"
+	"google.golang.org/grpc/codes"
+	"google.golang.org/grpc/connectivity"
+	"google.golang.org/grpc/status"
+	"google.golang.org/protobuf/proto"
+
+	pb "ebpf_edge/proto"
+)
+
+// -----------------------------------------------------------------------------
+// Membership & Failure Detection (SWIM)
+// -----------------------------------------------------------------------------
+//
+// Every SwimProbeInterval a node pings one member, walking a shuffled list so
+// each member is probed once per pass. A member that does not ack within
+// SwimProbeTimeout is probed again through SwimIndirectProbes random helpers
+// (PingReq), which tells a dead node apart from a bad path between two live
+// ones. If no helper gets an ack either, the member becomes suspect. A suspect
+// that does not refute within suspicionTimeout is declared dead. A node
+// refutes by announcing itself alive with a higher incarnation.
+//
+// Membership updates ride on pings, acks and gossip messages. Each is sent
+// swimRetransmits times, O(log n), which carries it to every node with high
+// probability. A node joins by pinging any seed with join set: the seed
+// answers with its whole member list and spreads the newcomer's alive record.
+//
+// Detection is bounded in rounds: with every node probing, a dead member is
+// probed within e/(e-1) intervals on average and one pass at worst. The
+// suspicion reaches every node in O(log n) intervals, and the member is
+// declared dead suspicionTimeout later. scheduleJob skips a member as soon as
+// it hears it is suspect.
+
+const (
+	// SwimProbeInterval is the protocol period: one member probed per interval.
+	SwimProbeInterval = 1 * time.Second
+
+	// SwimProbeTimeout is how long a direct ping may take before helpers are asked.
+	SwimProbeTimeout = 300 * time.Millisecond
+
+	// SwimIndirectProbes is how many helpers ping a member that missed a direct ping.
+	SwimIndirectProbes = 3
+
+	// SwimSuspicionMult scales the suspicion timeout, in probe intervals per log2(n+1).
+	SwimSuspicionMult = 3
+
+	// SwimRetransmitMult scales how many messages carry each update, per log2(n+1).
+	SwimRetransmitMult = 3
+
+	// SwimPiggybackMax bounds the membership updates attached to one message.
+	SwimPiggybackMax = 6
+
+	// SwimDeadRetention is how long a dead member is remembered, so a late
+	// alive record from before its death cannot bring it back.
+	SwimDeadRetention = 30 * time.Second
+)
+
+// Member states, as carried in pb.Member.State.
+const (
+	memberAlive uint32 = iota
+	memberSuspect
+	memberDead
+)
+
+var memberStateNames = []string{"alive", "suspect", "dead"}
+
+// memberRecord is what a node believes about one member.
+type memberRecord struct {
+	incarnation uint64
+	state       uint32
+	since       time.Time // When the member entered its state
+}
+
+// memberUpdate is an update still being disseminated.
+type memberUpdate struct {
+	m     *pb.Member
+	sends int
+}
+
+// memberList is this node's view of the cluster membership.
+type memberList struct {
+	mu          sync.Mutex
+	self        string
+	incarnation uint64
+	members     map[string]*memberRecord
+	queue       map[string]*memberUpdate // Latest update per member, until sent swimRetransmits times
+	order       []string                 // Probe order of the current pass
+	next        int
+	rnd         *rand.Rand
+}
+
+var membership = memberList{
+	members: make(map[string]*memberRecord),
+	queue:   make(map[string]*memberUpdate),
+	rnd:     rand.New(rand.NewSource(time.Now().UnixNano())),
+}
+
+// swimRounds is ceil(log2(n+1)), the O(log n) unit of the protocol's timeouts.
+func swimRounds(n int) int {
+	return int(math.Ceil(math.Log2(float64(n + 1))))
+}
+
+func swimRetransmits(n int) int {
+	return SwimRetransmitMult * swimRounds(n)
+}
+
+func suspicionTimeout(n int) time.Duration {
+	return SwimSuspicionMult * time.Duration(swimRounds(n)) * SwimProbeInterval
+}
+
+// start announces self and runs the probe loop until the returned function is called.
+// Incarnations start at the wall clock in ms, so a restarted node overrides
+// the dead record it left behind.
+func (l *memberList) start(self string, seeds []string) func() {
+	l.mu.Lock()
+	l.self = self
+	l.incarnation = uint64(time.Now().UnixMilli())
+	if self != "" {
+		l.enqueue(l.selfRecord())
+	}
+	l.mu.Unlock()
+
+	done := make(chan struct{})
+	stopped := make(chan struct{})
+	go func() {
+		defer close(stopped)
+		ticker := time.NewTicker(SwimProbeInterval)
+		defer ticker.Stop()
+		for {
+			select {
+			case <-done:
+				return
+			case now := <-ticker.C:
+				target, newPass := l.nextTarget(now)
+				if newPass {
+					l.joinSeeds(seeds)
+				}
+				if target != "" {
+					l.probe(target)
+				}
+			}
+		}
+	}()
+	return func() {
+		close(done)
+		<-stopped
+	}
+}
+
+// state returns what we believe about addr, and false if it is not a member.
+func (l *memberList) state(addr string) (uint32, bool) {
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	r, ok := l.members[addr]
+	if !ok {
+		return 0, false
+	}
+	return r.state, true
+}
+
+// addrs returns the seeds plus every member not known dead, excluding ourselves.
+func (l *memberList) addrs(seeds []string) []string {
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	set := make(map[string]bool, len(l.members)+len(seeds))
+	for _, ip := range seeds {
+		if ip = strings.TrimSpace(ip); ip != "" {
+			set[ip] = true
+		}
+	}
+	for addr, r := range l.members {
+		if r.state == memberDead {
+			delete(set, addr)
+		} else {
+			set[addr] = true
+		}
+	}
+	delete(set, l.self)
+
+	out := make([]string, 0, len(set))
+	for addr := range set {
+		out = append(out, addr)
+	}
+	sort.Strings(out)
+	return out
+}
+
+// merge applies membership updates received from another node.
+func (l *memberList) merge(updates []*pb.Member) {
+	if len(updates) == 0 {
+		return
+	}
+	now := time.Now()
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	for _, m := range updates {
+		l.apply(m, now)
+	}
+}
+
+// apply folds one update into the view and queues it for dissemination if it
+// changed anything. The caller holds l.mu.
+func (l *memberList) apply(m *pb.Member, now time.Time) {
+	if m.Addr == "" || m.State > memberDead {
+		return
+	}
+	if m.Addr == l.self {
+		// Someone suspects us or declared us dead: refute with a higher incarnation.
+		if m.State != memberAlive && m.Incarnation >= l.incarnation {
+			l.incarnation = m.Incarnation + 1
+			l.enqueue(l.selfRecord())
+			logDebug("[SWIM] refuting %s, incarnation %d", memberStateNames[m.State], l.incarnation)
+		}
+		return
+	}
+
+	cur, known := l.members[m.Addr]
+	if known && !supersedes(m, cur) {
+		return
+	}
+	if !known && m.State != memberAlive {
+		return // Only an alive record adds a member; a stale suspicion must not revive a forgotten one
+	}
+	l.members[m.Addr] = &memberRecord{incarnation: m.Incarnation, state: m.State, since: now}
+	l.enqueue(m)
+	if !known || cur.state != m.State {
+		logDebug("[SWIM] %s is %s (incarnation %d)", m.Addr, memberStateNames[m.State], m.Incarnation)
+	}
+}
+
+// supersedes reports whether m overrides cur: a higher incarnation always
+// does; at the same incarnation, suspect beats alive and dead beats both.
+func supersedes(m *pb.Member, cur *memberRecord) bool {
+	switch m.State {
+	case memberAlive:
+		return m.Incarnation > cur.incarnation
+	case memberSuspect:
+		return m.Incarnation > cur.incarnation || m.Incarnation == cur.incarnation && cur.state == memberAlive
+	default:
+		return m.Incarnation >= cur.incarnation && cur.state != memberDead
+	}
+}
+
+// enqueue replaces any pending update about the same member. The caller holds l.mu.
+func (l *memberList) enqueue(m *pb.Member) {
+	l.queue[m.Addr] = &memberUpdate{m: proto.Clone(m).(*pb.Member)}
+}
+
+// selfRecord is our own alive record. The caller holds l.mu.
+func (l *memberList) selfRecord() *pb.Member {
+	return &pb.Member{Addr: l.self, Incarnation: l.incarnation, State: memberAlive}
+}
+
+// piggyback returns up to SwimPiggybackMax pending updates to attach to an
+// outgoing message, the least sent first. An update is dropped once it has
+// been sent swimRetransmits times.
+func (l *memberList) piggyback() []*pb.Member {
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	if len(l.queue) == 0 {
+		return nil
+	}
+	pending := make([]*memberUpdate, 0, len(l.queue))
+	for _, u := range l.queue {
+		pending = append(pending, u)
+	}
+	sort.Slice(pending, func(i, j int) bool {
+		if pending[i].sends != pending[j].sends {
+			return pending[i].sends < pending[j].sends
+		}
+		return pending[i].m.Addr < pending[j].m.Addr
+	})
+	if len(pending) > SwimPiggybackMax {
+		pending = pending[:SwimPiggybackMax]
+	}
+
+	limit := swimRetransmits(len(l.members) + 1)
+	out := make([]*pb.Member, 0, len(pending))
+	for _, u := range pending {
+		out = append(out, u.m)
+		if u.sends++; u.sends >= limit {
+			delete(l.queue, u.m.Addr)
+		}
+	}
+	return out
+}
+
+// all returns every record we hold, ourselves included, for a joining node.
+func (l *memberList) all() []*pb.Member {
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	out := make([]*pb.Member, 0, len(l.members)+1)
+	if l.self != "" {
+		out = append(out, l.selfRecord())
+	}
+	for addr, r := range l.members {
+		out = append(out, &pb.Member{Addr: addr, Incarnation: r.incarnation, State: r.state})
+	}
+	return out
+}
+
+// nextTarget expires suspects and dead records, then returns the next member
+// to probe ("" if there is none) and whether a new pass started.
+func (l *memberList) nextTarget(now time.Time) (string, bool) {
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	timeout := suspicionTimeout(len(l.members) + 1)
+	for addr, r := range l.members {
+		switch {
+		case r.state == memberSuspect && now.Sub(r.since) > timeout:
+			l.apply(&pb.Member{Addr: addr, Incarnation: r.incarnation, State: memberDead}, now)
+		case r.state == memberDead && now.Sub(r.since) > SwimDeadRetention:
+			delete(l.members, addr)
+			delete(l.queue, addr)
+		}
+	}
+
+	newPass := false
+	for {
+		if l.next >= len(l.order) {
+			if newPass {
+				return "", true // Nothing to probe
+			}
+			l.order = l.order[:0]
+			for addr, r := range l.members {
+				if r.state != memberDead {
+					l.order = append(l.order, addr)
+				}
+			}
+			sort.Strings(l.order)
+			l.rnd.Shuffle(len(l.order), func(i, j int) { l.order[i], l.order[j] = l.order[j], l.order[i] })
+			l.next = 0
+			newPass = true
+			continue
+		}
+		addr := l.order[l.next]
+		l.next++
+		if r, ok := l.members[addr]; ok && r.state != memberDead {
+			return addr, newPass
+		}
+	}
+}
+
+// joinSeeds pings every seed that is not a live member with join set, and
+// merges the member lists they answer with. It runs once per probe pass, so
+// a node that starts alone, or whose seeds were down, joins once one is up.
+func (l *memberList) joinSeeds(seeds []string) {
+	l.mu.Lock()
+	var missing []string
+	for _, ip := range seeds {
+		ip = strings.TrimSpace(ip)
+		if ip == "" || ip == l.self {
+			continue
+		}
+		if r, ok := l.members[ip]; ok && r.state != memberDead {
+			continue
+		}
+		missing = append(missing, ip)
+	}
+	req := &pb.Probe{From: l.self, Join: true}
+	if l.self != "" {
+		req.Updates = []*pb.Member{l.selfRecord()}
+	}
+	l.mu.Unlock()
+
+	var wg sync.WaitGroup
+	for _, ip := range missing {
+		wg.Add(1)
+		go func(ip string) {
+			defer wg.Done()
+			ack, err := swimCall(ip, req, false, SwimProbeInterval)
+			if err != nil {
+				return
+			}
+			l.merge(ack.Updates)
+			// A seed without SWIM sends no record of itself; we still know it answered.
+			l.merge([]*pb.Member{{Addr: ip, State: memberAlive}})
+		}(ip)
+	}
+	wg.Wait()
+}
+
+// probe runs one SWIM probe of target: direct, then through helpers, then suspicion.
+func (l *memberList) probe(target string) {
+	req := &pb.Probe{From: l.self, Updates: l.updatesFor(target)}
+	if ack, err := swimCall(target, req, false, SwimProbeTimeout); err == nil {
+		l.merge(ack.Updates)
+		return
+	}
+
+	helpers := l.helpers(target, SwimIndirectProbes)
+	results := make(chan bool, len(helpers))
+	for _, h := range helpers {
+		go func(h string) {
+			req := &pb.Probe{From: l.self, Target: target, Updates: l.piggyback()}
+			ack, err := swimCall(h, req, true, SwimProbeInterval-SwimProbeTimeout)
+			if err == nil {
+				l.merge(ack.Updates)
+			}
+			results <- err == nil && ack.Ok
+		}(h)
+	}
+	for range helpers {
+		if <-results {
+			return
+		}
+	}
+
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	if r, ok := l.members[target]; ok && r.state == memberAlive {
+		l.apply(&pb.Member{Addr: target, Incarnation: r.incarnation, State: memberSuspect}, time.Now())
+	}
+}
+
+// updatesFor is the piggyback for a ping to target. A suspect target always
+// gets its own suspect record, so it can refute even after the update
+// stopped being disseminated.
+func (l *memberList) updatesFor(target string) []*pb.Member {
+	updates := l.piggyback()
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	if r, ok := l.members[target]; ok && r.state == memberSuspect {
+		updates = append(updates, &pb.Member{Addr: target, Incarnation: r.incarnation, State: memberSuspect})
+	}
+	return updates
+}
+
+// helpers picks up to k live members other than target to probe it indirectly.
+func (l *memberList) helpers(target string, k int) []string {
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	var candidates []string
+	for addr, r := range l.members {
+		if addr != target && r.state == memberAlive {
+			candidates = append(candidates, addr)
+		}
+	}
+	sort.Strings(candidates)
+	return pickTargets(candidates, k, l.rnd)
+}
+
+// onPing answers a direct probe. A joining node gets every record we hold.
+func (l *memberList) onPing(p *pb.Probe) *pb.ProbeAck {
+	l.merge(p.Updates)
+	if p.Join {
+		return &pb.ProbeAck{Ok: true, Updates: l.all()}
+	}
+	return &pb.ProbeAck{Ok: true, Updates: l.piggyback()}
+}
+
+// onPingReq probes p.Target on the sender's behalf.
+func (l *memberList) onPingReq(p *pb.Probe) *pb.ProbeAck {
+	l.merge(p.Updates)
+	req := &pb.Probe{From: l.self, Updates: l.piggyback()}
+	ack, err := swimCall(p.Target, req, false, SwimProbeTimeout)
+	if err == nil {
+		l.merge(ack.Updates)
+	}
+	return &pb.ProbeAck{Ok: err == nil, Updates: l.piggyback()}
+}
+
+// swimCall sends a Ping (or PingReq if indirect) to addr over the pooled connection.
+// A peer that predates SWIM answers Ping with Unimplemented, which still
+// proves it is up; it cannot act as a helper.
+//
+// A connection that lost its peer waits out reconnect backoff (up to
+// PeerReconnectMaxDelay), and an RPC on it fails at once. A restarted peer
+// would then miss every probe until the backoff ran out. So the backoff is
+// cut short and the probe waits for the connection within its deadline: it
+// fails only if the peer does not answer in time.
+func swimCall(addr string, req *pb.Probe, indirect bool, timeout time.Duration) (*pb.ProbeAck, error) {
+	conn, err := peerConns.get(addr)
+	if err != nil {
+		return nil, err
+	}
+	if conn.GetState() == connectivity.TransientFailure {
+		conn.ResetConnectBackoff()
+	}
+	client := pb.NewMetricsServiceClient(conn)
+	ctx, cancel := context.WithTimeout(context.Background(), timeout)
+	defer cancel()
+
+	var ack *pb.ProbeAck
+	if indirect {
+		ack, err = client.PingReq(ctx, req, grpc.WaitForReady(true))
+	} else {
+		ack, err = client.Ping(ctx, req, grpc.WaitForReady(true))
+		if status.Code(err) == codes.Unimplemented {
+			return &pb.ProbeAck{Ok: true}, nil
+		}
+	}
+	return ack, err
+}
+
+// withMembers attaches membership updates to every form of the update.
+// The full state is shared across ticks, so it is copied rather than modified.
+func (u *gossipUpdate) withMembers(members []*pb.Member) *gossipUpdate {
+	if len(members) == 0 {
+		return u
+	}
+	full := proto.Clone(u.full).(*pb.MetricsSnapshot)
+	full.Members = members
+	u.full = full
+	u.heartbeat.Members = members
+	if u.delta != nil {
+		u.delta.Members = members
+	}
+	return u
+}
@@ -0,0 +1,46 @@
+package cmd
+
+import (
+	"testing"
+
+	pb "ebpf_edge/proto"
+)
+
+func TestSupersedes(t *testing.T) {
+	tests := []struct {
+		name     string
+		curInc   uint64
+		curState uint32
+		inc      uint64
+		state    uint32
+		want     bool
+	}{
+		{"alive, same incarnation", 3, memberAlive, 3, memberAlive, false},
+		{"alive, higher incarnation", 3, memberAlive, 4, memberAlive, true},
+		{"refutation of a suspicion", 3, memberSuspect, 4, memberAlive, true},
+		{"alive does not refute at the same incarnation", 3, memberSuspect, 3, memberAlive, false},
+		{"alive does not revive the dead at the same incarnation", 3, memberDead, 3, memberAlive, false},
+		{"alive rejoins after death", 3, memberDead, 4, memberAlive, true},
+		{"stale alive", 3, memberAlive, 2, memberAlive, false},
+		{"suspicion of an alive member", 3, memberAlive, 3, memberSuspect, true},
+		{"repeated suspicion", 3, memberSuspect, 3, memberSuspect, false},
+		{"suspicion at a higher incarnation", 3, memberSuspect, 4, memberSuspect, true},
+		{"stale suspicion", 3, memberAlive, 2, memberSuspect, false},
+		{"suspicion of the dead", 3, memberDead, 3, memberSuspect, false},
+		{"death of an alive member", 3, memberAlive, 3, memberDead, true},
+		{"death of a suspect", 3, memberSuspect, 3, memberDead, true},
+		{"death at a higher incarnation", 3, memberSuspect, 4, memberDead, true},
+		{"repeated death", 3, memberDead, 4, memberDead, false},
+		{"stale death", 3, memberAlive, 2, memberDead, false},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			m := &pb.Member{Addr: "10.0.0.2", Incarnation: tt.inc, State: tt.state}
+			cur := &memberRecord{incarnation: tt.curInc, state: tt.curState}
+			if got := supersedes(m, cur); got != tt.want {
+				t.Errorf("supersedes(%d@%d over %d@%d) = %v, want %v",
+					tt.state, tt.inc, tt.curState, tt.curInc, got, tt.want)
+			}
+		})
+	}
+}
@@ -1,119 +1,330 @@
 package cmd
 
 import (
-	"bufio"
+	"errors"
 	"fmt"
 	"log"
 	"os"
-	"strconv"
-	"strings"
+	"os/signal"
+	"syscall"
 	"time"
 
+	"github.com/cilium/ebpf"
+	"github.com/cilium/ebpf/link"
+	"github.com/cilium/ebpf/ringbuf"
+	"github.com/cilium/ebpf/rlimit"
 	"github.com/spf13/cobra"
 )
 
 // --- CLI Command Setup ---
 var memwatchCmd = &cobra.Command{
 	Use:   "memwatch",
-	Short: "Collect memory saturation via /proc/meminfo",
+	Short: "Collect memory saturation via /proc/meminfo (+ eBPF reclaim stalls with --mem-ebpf)",
 	Run:   runMemWatch,
 }
 
 func init() {
 	rootCmd.AddCommand(memwatchCmd)
+	rootCmd.PersistentFlags().BoolVar(&memEBPF, "mem-ebpf", false, "Trace direct-reclaim stalls and OOM kills with eBPF")
+	registerCollector("MEM", false, openMEMCollector)
 }
 
-// --- The Collector Function ---
-// StartMEMCollector starts a ticker that reads /proc/meminfo every 1s
-// Returns: A channel of float64 representing Memory Usage %
-func StartMEMCollector() (<-chan float64, func(), error) {
-	out := make(chan float64)
-	done := make(chan struct{})
+// memEBPF enables the optional eBPF reclaim/OOM probes alongside /proc/meminfo.
+var memEBPF bool
 
-	// Cleanup function to stop the polling routine
-	cleanup := func() {
-		close(done)
+// Generate the pressure probes. They read no tracepoint fields, so one object fits all kernels.
+//go:generate go run github.com/cilium/ebpf/cmd/bpf2go mem_pressure ../bpf/mem_pressure.c -- -O2 -target bpf -I/usr/include/x86_64-linux-gnu
+
+// memStallEventNS is the direct-reclaim stall length that wakes the collector early.
+const memStallEventNS = uint64(time.Millisecond)
+
+// memWakeMinGap rate-limits early samples triggered by kernel events.
+const memWakeMinGap = 100 * time.Millisecond
+
+// memOOMWindow is how long an OOM kill keeps counting in the published reading.
+// It spans several gossip rounds, so every scheduler hears of the kill before
+// it expires, and keeps new work off the node while the kernel recovers.
+const memOOMWindow = 10 * GossipInterval
+
+// MemReading is one memory sample.
+type MemReading struct {
+	Percent  float64 // Saturation % from MemTotal/MemAvailable
+	StallMs  float64 // Direct-reclaim stall per second of wall time (eBPF only)
+	OOMKills uint64  // OOM victims within the last memOOMWindow (eBPF only)
+}
+
+// memStats mirrors 'struct mem_stats' in bpf/mem_pressure.c.
+type memStats struct {
+	StallNS  uint64
+	Stalls   uint64
+	OOMKills uint64
+}
+
+// memPressureBPF holds the loaded reclaim/OOM probes.
+type memPressureBPF struct {
+	stats   *ebpf.Map
+	events  *ringbuf.Reader
+	cleanup func()
+}
+
+func startMemPressure() (*memPressureBPF, error) {
+	if err := rlimit.RemoveMemlock(); err != nil {
+		return nil, fmt.Errorf("rlimit error: %v", err)
+	}
+
+	spec, err := loadMem_pressure()
+	if err != nil {
+		return nil, fmt.Errorf("load mem spec: %v", err)
+	}
+	stallEvent, ok := spec.Variables["stall_event_ns"]
+	if !ok {
+		return nil, fmt.Errorf("missing variable stall_event_ns")
+	}
+	if err := stallEvent.Set(memStallEventNS); err != nil {
+		return nil, fmt.Errorf("set stall_event_ns: %v", err)
+	}
+	var objs mem_pressureObjects
+	if err := spec.LoadAndAssign(&objs, nil); err != nil {
+		return nil, fmt.Errorf("load mem: %v", err)
+	}
+
+	var links []link.Link
+	closeAll := func() {
+		for _, l := range links {
+			l.Close()
+		}
+		objs.Close()
 	}
 
-	go func() {
-		defer close(out)
-		ticker := time.NewTicker(1 * time.Second)
-		defer ticker.Stop()
+	hooks := []struct {
+		group, name string
+		prog        *ebpf.Program
+	}{
+		{"vmscan", "mm_vmscan_direct_reclaim_begin", objs.HandleReclaimBegin},
+		{"vmscan", "mm_vmscan_direct_reclaim_end", objs.HandleReclaimEnd},
+		{"oom", "mark_victim", objs.HandleOomVictim},
+	}
+	for _, h := range hooks {
+		l, err := link.Tracepoint(h.group, h.name, h.prog, nil)
+		if err != nil {
+			closeAll()
+			return nil, fmt.Errorf("attach %s: %v", h.name, err)
+		}
+		links = append(links, l)
+	}
+
+	rd, err := ringbuf.NewReader(objs.MemEvents)
+	if err != nil {
+		closeAll()
+		return nil, fmt.Errorf("open mem ringbuf: %v", err)
+	}
+
+	return &memPressureBPF{
+		stats:  objs.MemStats,
+		events: rd,
+		cleanup: func() {
+			rd.Close()
+			closeAll()
+		},
+	}, nil
+}
 
-		for {
-			select {
-			case <-done:
+// read returns the cumulative stall time and OOM kills summed across CPUs.
+func (p *memPressureBPF) read() (stallNS, oomKills uint64, err error) {
+	var key uint32 = 0
+	var perCPU []memStats
+	if err := p.stats.Lookup(&key, &perCPU); err != nil {
+		return 0, 0, err
+	}
+	for _, s := range perCPU {
+		stallNS += s.StallNS
+		oomKills += s.OOMKills
+	}
+	return stallNS, oomKills, nil
+}
+
+// watch blocks on kernel pressure events and calls wake so the sampling loop
+// samples memory immediately instead of waiting for the next tick.
+func (p *memPressureBPF) watch(wake func()) {
+	var rec ringbuf.Record
+	var lastWake time.Time
+	for {
+		if err := p.events.ReadInto(&rec); err != nil {
+			if errors.Is(err, ringbuf.ErrClosed) {
 				return
-			case <-ticker.C:
-				usage, err := getMemoryUsage()
-				if err != nil {
-					log.Printf("Error reading memory: %v", err)
-					continue
-				}
-				out <- usage
 			}
+			continue
+		}
+		if time.Since(lastWake) < memWakeMinGap {
+			continue
 		}
-	}()
+		lastWake = time.Now()
+		wake()
+	}
+}
 
-	return out, cleanup, nil
+// memPollInterval is how often the sampling loop reads /proc/meminfo.
+const memPollInterval = 1 * time.Second
+
+// --- The Collector ---
+// memCollector reads /proc/meminfo on every sample.
+// With --mem-ebpf it is also woken early whenever the kernel reports a reclaim stall or OOM kill.
+type memCollector struct {
+	meminfo  *meminfoReader
+	pressure *memPressureBPF // nil without --mem-ebpf or when the probes failed to load
+
+	lastStall, lastOOM uint64
+	stallSince         time.Time  // Start of the window the next stall rate covers
+	stallMs            float64    // Latest stall rate, kept for samples too close to the last one
+	recentOOM          []oomBatch // Kills seen by samples within memOOMWindow, oldest first
 }
 
-// --- Helper: Parse /proc/meminfo ---
-func getMemoryUsage() (float64, error) {
-	file, err := os.Open("/proc/meminfo")
+// oomBatch is the OOM kills one sample observed.
+type oomBatch struct {
+	at    time.Time
+	kills uint64
+}
+
+func openMEMCollector(wake func()) (Collector, error) {
+	meminfo, err := openMeminfo()
 	if err != nil {
-		return 0, err
+		return nil, fmt.Errorf("open meminfo: %v", err)
+	}
+	c := &memCollector{meminfo: meminfo, stallSince: time.Now()}
+
+	if memEBPF {
+		p, err := startMemPressure()
+		if err != nil {
+			// Optional: fall back to /proc/meminfo alone.
+			log.Printf("eBPF memory probes disabled: %v", err)
+		} else {
+			c.pressure = p
+			c.lastStall, c.lastOOM, _ = p.read()
+			go p.watch(wake)
+		}
 	}
-	defer file.Close()
+	return c, nil
+}
 
-	var memTotal, memAvailable float64
-	scanner := bufio.NewScanner(file)
+func (c *memCollector) Interval() time.Duration { return memPollInterval }
 
-	// We scan the file line by line looking for specific keys
-	for scanner.Scan() {
-		line := scanner.Text()
-		if strings.HasPrefix(line, "MemTotal:") {
-			parts := strings.Fields(line)
-			if len(parts) >= 2 {
-				memTotal, _ = strconv.ParseFloat(parts[1], 64)
+func (c *memCollector) Close() {
+	if c.pressure != nil {
+		c.pressure.cleanup()
+	}
+	c.meminfo.Close()
+}
+
+func (c *memCollector) Sample(now time.Time, m *LocalMetrics) error {
+	usage, err := c.meminfo.usage()
+	if err != nil {
+		return err
+	}
+	r := MemReading{Percent: usage}
+
+	if c.pressure != nil {
+		if stall, oom, err := c.pressure.read(); err == nil {
+			// A wake right after a tick would divide the stall by a window of a
+			// few ms and inflate the rate a hundredfold. Below memWakeMinGap the
+			// previous rate stands and the stall carries into the next window.
+			if elapsed := now.Sub(c.stallSince); elapsed >= memWakeMinGap {
+				c.stallMs = float64(stall-c.lastStall) / 1e6 / elapsed.Seconds()
+				c.lastStall, c.stallSince = stall, now
 			}
-		}
-		if strings.HasPrefix(line, "MemAvailable:") {
-			parts := strings.Fields(line)
-			if len(parts) >= 2 {
-				memAvailable, _ = strconv.ParseFloat(parts[1], 64)
+			r.StallMs = c.stallMs
+			if oom > c.lastOOM {
+				c.recentOOM = append(c.recentOOM, oomBatch{at: now, kills: oom - c.lastOOM})
 			}
+			c.lastOOM = oom
 		}
-		// Optimization: Stop reading once we have both values
-		if memTotal > 0 && memAvailable > 0 {
-			break
+		r.OOMKills = c.recentOOMKills(now)
+	}
+	m.UpdateMem(r)
+	return nil
+}
+
+// recentOOMKills drops the batches older than memOOMWindow and sums the rest.
+// A kill lasts the whole window, instead of one sample the next tick overwrites.
+func (c *memCollector) recentOOMKills(now time.Time) uint64 {
+	expired := 0
+	for expired < len(c.recentOOM) && now.Sub(c.recentOOM[expired].at) > memOOMWindow {
+		expired++
+	}
+	c.recentOOM = c.recentOOM[expired:]
+
+	var kills uint64
+	for _, b := range c.recentOOM {
+		kills += b.kills
+	}
+	return kills
+}
+
+// --- Helper: Parse /proc/meminfo ---
+
+// meminfoReader keeps /proc/meminfo open and parses it without allocating.
+// The agent runs beside the workloads on 4 GB boards, so it avoids feeding the GC every tick.
+type meminfoReader struct {
+	file *procFile
+}
+
+func openMeminfo() (*meminfoReader, error) {
+	// /proc/meminfo is ~1.5 KB; procFile grows the buffer if a kernel prints more.
+	f, err := openProcFile("/proc/meminfo", 4096)
+	if err != nil {
+		return nil, err
+	}
+	return &meminfoReader{file: f}, nil
+}
+
+func (r *meminfoReader) Close() error {
+	return r.file.Close()
+}
+
+// usage returns the memory saturation percentage.
+func (r *meminfoReader) usage() (float64, error) {
+	buf, err := r.file.read()
+	if err != nil {
+		return 0, err
+	}
+
+	var memTotal, memAvailable uint64
+	var haveTotal, haveAvailable bool
+
+	// We scan the buffer line by line looking for specific keys
+	for rest := buf; len(rest) > 0 && !(haveTotal && haveAvailable); {
+		var line []byte
+		line, rest = nextLine(rest)
+		if hasPrefix(line, "MemTotal:") {
+			memTotal, _, haveTotal = parseUint(line[len("MemTotal:"):])
+		} else if hasPrefix(line, "MemAvailable:") {
+			memAvailable, _, haveAvailable = parseUint(line[len("MemAvailable:"):])
 		}
 	}
 
-	if memTotal == 0 {
+	if !haveTotal || memTotal == 0 {
 		return 0, fmt.Errorf("could not determine MemTotal")
 	}
 
 	// Calculation:
 	// Saturation % = (Total - Available) / Total * 100
-	usedPercent := ((memTotal - memAvailable) / memTotal) * 100.0
+	usedPercent := (float64(memTotal-memAvailable) / float64(memTotal)) * 100.0
 	return usedPercent, nil
 }
 
 // --- Run Handler ---
 func runMemWatch(cmd *cobra.Command, args []string) {
-	memStream, cleanup, err := StartMEMCollector()
+	var local LocalMetrics
+	cleanup, err := startCollectors(&local, func() {
+		v := local.Read()
+		logDebug("MEM Saturation: %.2f%% | Reclaim stall: %.1f ms/s | OOM kills: %d\n", v.MemPercent, v.MemStallMs, v.OOMKills)
+	}, "MEM")
 	if err != nil {
 		log.Fatalf("Init error: %v", err)
 	}
 	defer cleanup()
 
 	logDebug("Collecting MEMORY usage... CTRL+C to stop")
-
-	// Just for demo purposes, handle signal to exit cleanly
-	// (In your main agent, this logic is likely handled elsewhere)
-	// for v := range memStream { ... }
-	for v := range memStream {
-		logDebug("MEM Saturation: %.2f%%\n", v)
-	}
+	stop := make(chan os.Signal, 1)
+	signal.Notify(stop, syscall.SIGINT, syscall.SIGTERM)
+	<-stop
 }
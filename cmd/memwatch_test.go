@@ -0,0 +1,103 @@
+package cmd
+
+import (
+	"math"
+	"os"
+	"path/filepath"
+	"testing"
+)
+
+// fakeMeminfo opens a meminfoReader over a temporary file with the given contents.
+func fakeMeminfo(t *testing.T, contents string) *meminfoReader {
+	t.Helper()
+	path := filepath.Join(t.TempDir(), "meminfo")
+	if err := os.WriteFile(path, []byte(contents), 0o644); err != nil {
+		t.Fatal(err)
+	}
+	f, err := openProcFile(path, 64) // Small on purpose: exercises the buffer growth
+	if err != nil {
+		t.Fatal(err)
+	}
+	r := &meminfoReader{file: f}
+	t.Cleanup(func() { r.Close() })
+	return r
+}
+
+func TestMeminfoUsage(t *testing.T) {
+	tests := []struct {
+		name     string
+		contents string
+		want     float64
+		wantErr  bool
+	}{
+		{
+			name:     "typical",
+			contents: "MemTotal:        4000000 kB\nMemFree:          500000 kB\nMemAvailable:    1000000 kB\nBuffers:           10000 kB\n",
+			want:     75,
+		},
+		{
+			name:     "available listed first",
+			contents: "MemAvailable:    3000000 kB\nMemTotal:        4000000 kB\n",
+			want:     25,
+		},
+		{
+			name:     "no MemAvailable counts as full",
+			contents: "MemTotal:        4000000 kB\nMemFree:         4000000 kB\n",
+			want:     100,
+		},
+		{
+			name:     "no MemTotal",
+			contents: "MemFree:          500000 kB\nMemAvailable:    1000000 kB\n",
+			wantErr:  true,
+		},
+		{
+			name:     "zero MemTotal",
+			contents: "MemTotal:              0 kB\n",
+			wantErr:  true,
+		},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			got, err := fakeMeminfo(t, tt.contents).usage()
+			if (err != nil) != tt.wantErr {
+				t.Fatalf("usage() error = %v, wantErr %v", err, tt.wantErr)
+			}
+			if !tt.wantErr && math.Abs(got-tt.want) > 1e-9 {
+				t.Errorf("usage() = %g, want %g", got, tt.want)
+			}
+		})
+	}
+}
+
+// TestMeminfoReaderAllocs guards the point of the reader: a steady-state sample does not allocate.
+func TestMeminfoReaderAllocs(t *testing.T) {
+	r, err := openMeminfo()
+	if err != nil {
+		t.Skipf("no /proc/meminfo: %v", err)
+	}
+	defer r.Close()
+
+	allocs := testing.AllocsPerRun(1000, func() {
+		if _, err := r.usage(); err != nil {
+			t.Fatal(err)
+		}
+	})
+	if allocs != 0 {
+		t.Errorf("meminfo sample allocates %.2f times, want 0", allocs)
+	}
+}
+
+func BenchmarkMeminfoReader(b *testing.B) {
+	r, err := openMeminfo()
+	if err != nil {
+		b.Skipf("no /proc/meminfo: %v", err)
+	}
+	defer r.Close()
+
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		if _, err := r.usage(); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
@@ -29,9 +29,13 @@ import (
 // -----------------------------------------------------------------------------
 
 const (
-	// NodeTTL defines the maximum silence duration before a node is considered stale/offline.
+	// NodeTTL defines the maximum silence duration before a node is considered
+	// stale/offline. SWIM can declare a member offline sooner, never later.
 	NodeTTL = 4 * time.Second
 
+	// GossipInterval is how often each node sends its metrics.
+	GossipInterval = 3 * time.Second
+
 	// PeerPort is the TCP port used for gRPC communication between nodes.
 	PeerPort = "60000"
 
@@ -40,6 +44,20 @@ const (
 
 	// DockerShortIDLength is the standard length for displaying Docker container IDs.
 	DockerShortIDLength = 12
+
+	// MemStallLimitMs is the direct-reclaim stall (ms per second) above which a node
+	// is considered under memory pressure regardless of its MemAvailable figure.
+	MemStallLimitMs = 50.0
+
+	// PSI limits (avg10, % of wall time). CPU uses "some": a runnable task waited for a core.
+	// Memory and IO use "full": every task was stalled, so the node did no useful work.
+	CPUPressureLimit = 20.0
+	MemPressureLimit = 5.0
+	IOPressureLimit  = 20.0
+
+	// RunqLatencyLimitUs is the p99 wakeup-to-run delay above which a node is only
+	// used when no better one is available: short functions spend their SLO waiting for a CPU.
+	RunqLatencyLimitUs = 5000.0
 )
 
 var targetPeers []string
@@ -62,11 +80,14 @@ func init() {
 type NodeData struct {
 	Snapshot *pb.MetricsSnapshot
 	LastSeen time.Time
+	Relays   int // Rounds this version has been relayed onward (epidemic gossip)
 }
 
 type ClusterState struct {
 	mu      sync.RWMutex
 	Metrics map[string]NodeData
+	self    string // Our advertised address: states about ourselves are ignored
+	live    int    // Nodes heard of within nodeTTL and not dead to SWIM, ourselves included (see expire)
 }
 
 var globalCluster = ClusterState{
@@ -82,6 +103,52 @@ func (c *ClusterState) Update(ip string, snap *pb.MetricsSnapshot) {
 	}
 }
 
+// Apply folds a gossip message (full, delta or heartbeat) from ip into the
+// cluster state, along with any third-party states and membership updates
+// that came with it. A message naming its node is stored under that address
+// instead of ip. fresh is passed on to applyGossip.
+// It returns applyGossip's error if the sender's state was left unchanged.
+func (c *ClusterState) Apply(ip string, msg *pb.MetricsSnapshot, fresh bool) error {
+	// Piggybacked membership updates are for SWIM, not part of the state.
+	membership.merge(msg.Members)
+	msg.Members = nil
+	return c.applyAt(ip, msg, fresh, time.Now())
+}
+
+func (c *ClusterState) applyAt(ip string, msg *pb.MetricsSnapshot, fresh bool, now time.Time) error {
+	// Received messages are owned by the caller; detach the relayed states
+	// so they are not stored (or relayed again) nested inside this one.
+	relayed := msg.Relayed
+	msg.Relayed = nil
+	if msg.Node != "" {
+		ip = msg.Node
+	}
+
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	for _, r := range relayed {
+		c.mergeRelayed(r, now)
+	}
+	if ip == c.self {
+		return nil
+	}
+	prev := c.Metrics[ip]
+	next, err := applyGossip(prev.Snapshot, msg, fresh)
+	if err != nil {
+		return err
+	}
+	relays := prev.Relays
+	if prev.Snapshot == nil || next.Version != prev.Snapshot.Version {
+		relays = 0 // A new version is a new rumor
+	}
+	c.Metrics[ip] = NodeData{
+		Snapshot: next,
+		LastSeen: now,
+		Relays:   relays,
+	}
+	return nil
+}
+
 func (c *ClusterState) Snapshot() map[string]NodeData {
 	c.mu.RLock()
 	defer c.mu.RUnlock()
@@ -99,6 +166,17 @@ func (c *ClusterState) Snapshot() map[string]NodeData {
 func scheduleJob(job *pb.JobRequest) (string, error) {
 	// 1. Get current cluster view
 	view := globalCluster.Snapshot()
+	live := globalCluster.liveNodes()
+
+	// 2. Refine the CPU request with what this job measured on previous runs here.
+	// Declared requests are guesses; the cgroup accounting knows the real cost.
+	// The cost is in cores, and each candidate converts it by its own core
+	// count below: one core is 25% of a Pi 5 but under 17% of a 6-core Orin.
+	// The job itself is forwarded as declared: the receiver applies its own estimate.
+	learnedCores, learned := jobCosts.estimate(job.Name)
+	if learned {
+		logDebug("[SCHEDULER] %s: using measured CPU cost %.2f cores (declared %.1f%%)\n", job.Name, learnedCores, job.ReqCpu)
+	}
 
 	logDebug("[SCHEDULER] Assessing candidates for %s (Req: %.1f CPU, %.1f MEM)\n", job.Name, job.ReqCpu, job.ReqMem)
 
@@ -108,34 +186,53 @@ func scheduleJob(job *pb.JobRequest) (string, error) {
 	// 3. Filter Candidates based on Capacity
 	for ip, data := range view {
 		// A. Check Liveness
-		if time.Since(data.LastSeen) > NodeTTL {
+		if !nodeLive(ip, data, live) {
 			continue
 		}
 
 		m := data.Snapshot
+		reqCPU := job.ReqCpu
+		if learned {
+			reqCPU = learnedCores / nodeCores(m) * 100.0
+		}
 
 		// B. Check Resource Capacity
 		// We ensure the node has enough headroom for the request.
 		// Thresholds: Max 95% CPU, Max 90% MEM.
-		cpuOk := (m.Cpu + job.ReqCpu) < 95.0
-		memOk := (m.Mem + job.ReqMem) < 90.0
-
-		if cpuOk && memOk {
+		// Reclaim stalls and OOM kills reveal pressure that MemAvailable alone reports late.
+		// PSI tells contention apart from utilization: 85% CPU with an empty runqueue
+		// beats 70% with tasks queuing. Peers without PSI report zeros and pass.
+		// Nodes reporting clock data are judged on the capacity they actually consume:
+		// 50% busy at a quarter of max clock leaves most of the core free to ramp into.
+		cpuOk := (nodeCPULoad(m)+reqCPU) < 95.0 && m.GetCpuPressure().GetSomeAvg10() < CPUPressureLimit
+		memOk := (m.Mem+job.ReqMem) < 90.0 && m.MemStallMs < MemStallLimitMs && m.OomKills == 0 &&
+			m.GetMemPressure().GetFullAvg10() < MemPressureLimit
+		ioOk := m.GetIoPressure().GetFullAvg10() < IOPressureLimit
+
+		if cpuOk && memOk && ioOk {
 			validCandidates = append(validCandidates, ip)
 
 			// --- FIX START: Handle Empty Temp ---
-			displayTemp := m.TempStatus
+			tempStatus, secsToWarm := jobThermalStatus(m, job)
+			displayTemp := tempStatus
 			if displayTemp == "" {
 				displayTemp = "N/A"
 			}
 
 			// C. Check Thermal Safety
 			// Policy: If Status is SAFE *OR* N/A (x86 machines sometimes give invalid value), we consider it safe for now.
-			if m.TempStatus == "SAFE" || m.TempStatus == "" {
+			// A SAFE node that is predicted to turn WARM before the job finishes is treated like a WARM one:
+			// throttled nodes run CPU-bound functions 30-50% slower.
+			heatingUp := secsToWarm > 0 && secsToWarm < job.ExpectedDurationS
+			if (tempStatus == "SAFE" || tempStatus == "") && !heatingUp {
 				safeCandidates = append(safeCandidates, ip)
 			}
+			if heatingUp {
+				displayTemp = fmt.Sprintf("%s (WARM in %.0fs)", displayTemp, secsToWarm)
+			}
 
-			logDebug(" -> Candidate Found: %s | CPU: %.1f%% | Temp: %s\n", ip, m.Cpu, displayTemp)
+			logDebug(" -> Candidate Found: %s | CPU: %.1f%% (PSI %.1f%%, runq p99 %.0fus) | Temp: %s\n",
+				ip, m.Cpu, m.GetCpuPressure().GetSomeAvg10(), m.RunqP99Us, displayTemp)
 		}
 	}
 
@@ -151,6 +248,34 @@ func scheduleJob(job *pb.JobRequest) (string, error) {
 		finalPool = safeCandidates
 	}
 
+	// 4b. Scheduling Delay Preference
+	// Within the chosen tier, prefer nodes whose run queue hands out a CPU quickly.
+	// Utilization can look fine while woken tasks queue behind each other.
+	var responsive []string
+	for _, ip := range finalPool {
+		if view[ip].Snapshot.RunqP99Us < RunqLatencyLimitUs {
+			responsive = append(responsive, ip)
+		}
+	}
+	if len(responsive) > 0 {
+		finalPool = responsive
+	}
+
+	// 4c. Idle Core Preference
+	// A single-threaded job cannot use spare capacity spread over several cores;
+	// it needs one core to itself. Prefer nodes that report a genuinely idle core.
+	if job.Threads == 1 {
+		var withIdleCore []string
+		for _, ip := range finalPool {
+			if view[ip].Snapshot.IdleCores > 0 {
+				withIdleCore = append(withIdleCore, ip)
+			}
+		}
+		if len(withIdleCore) > 0 {
+			finalPool = withIdleCore
+		}
+	}
+
 	// 5. Optimization & Selection
 	selectedIP := finalPool[rand.Intn(len(finalPool))]
 
@@ -179,6 +304,67 @@ func scheduleJob(job *pb.JobRequest) (string, error) {
 
 }
 
+// nodeLive reports whether the scheduler may place work on ip: its metrics
+// must be younger than nodeTTL. SWIM only excludes members sooner: a suspect
+// is skipped as soon as the suspicion is heard. An alive member whose metrics
+// stopped arriving still ages out, since its last metrics no longer describe it.
+func nodeLive(ip string, data NodeData, n int) bool {
+	if ip == "localhost" {
+		return true
+	}
+	if state, ok := membership.state(ip); ok && state != memberAlive {
+		return false
+	}
+	return time.Since(data.LastSeen) <= nodeTTL(n)
+}
+
+// nodeCPULoad is the CPU figure placement compares against: the clock-scaled
+// load when the node reports cpufreq data, the plain utilization otherwise.
+func nodeCPULoad(m *pb.MetricsSnapshot) float64 {
+	if m.FreqRatio > 0 {
+		return m.EffCpu
+	}
+	return m.Cpu
+}
+
+// nodeCores is the number of CPUs a node's CPU figures are a share of.
+// Peers that do not advertise it are assumed to match this node.
+func nodeCores(m *pb.MetricsSnapshot) float64 {
+	if m.Cores > 0 {
+		return float64(m.Cores)
+	}
+	return currentCPUCapacity()
+}
+
+// jobThermalStatus returns the thermal status and time-to-WARM that matter for the job.
+// Jobs naming a zone (e.g. "cpu" or "gpu") are judged by the matching zones:
+// the hottest sets the status, the first predicted to turn WARM the time.
+// Otherwise, or when the node has no such zone, the whole node decides.
+func jobThermalStatus(m *pb.MetricsSnapshot, job *pb.JobRequest) (string, float64) {
+	if job.ThermalZone == "" {
+		return m.TempStatus, m.SecsToWarm
+	}
+	want := strings.ToLower(job.ThermalZone)
+	found := false
+	var hottest, secsToWarm float64
+	for _, z := range m.Zones {
+		if !strings.Contains(strings.ToLower(z.Name), want) {
+			continue
+		}
+		if !found || z.TempC > hottest {
+			hottest = z.TempC
+		}
+		if z.SecsToWarm > 0 && (secsToWarm == 0 || z.SecsToWarm < secsToWarm) {
+			secsToWarm = z.SecsToWarm
+		}
+		found = true
+	}
+	if !found {
+		return m.TempStatus, m.SecsToWarm
+	}
+	return classifyTemp(hottest), secsToWarm
+}
+
 // CHANGE 2: executeDockerContainer blocks and returns error
 func executeDockerContainer(job *pb.JobRequest) error {
 	ctx := context.Background()
@@ -205,40 +391,71 @@ func executeDockerContainer(job *pb.JobRequest) error {
 	}
 
 	// 3. Start
+	started := time.Now()
 	if err := cli.ContainerStart(ctx, resp.ID, container.StartOptions{}); err != nil {
 		return fmt.Errorf("start fail: %v", err)
 	}
 
 	logDebug("[DOCKER] Container %s running... waiting for completion.\n", resp.ID[:12])
 
+	// Account the container's cgroup so the job's real CPU cost can be learned.
+	cgroupID, tracked := trackContainer(ctx, cli, resp.ID, job.Name, started)
+
 	// 4. WAIT (Blocking)
 	statusCh, errCh := cli.ContainerWait(ctx, resp.ID, container.WaitConditionNotRunning)
 	select {
 	case err := <-errCh:
+		if tracked {
+			localContainers.finish(cgroupID) // Drop the entry; the measurement is incomplete
+		}
 		return fmt.Errorf("wait error: %v", err)
 	case <-statusCh:
 		// Success!
 		logDebug("[DOCKER] Container %s finished.\n", resp.ID[:DockerShortIDLength])
+		if tracked {
+			if c, cost, err := localContainers.finish(cgroupID); err == nil {
+				jobCosts.observe(c.Job, cost)
+				logDebug("[DOCKER] %s used %.2f cores on average\n", c.Job, cost)
+			} else {
+				logDebug("[DOCKER] CPU cost unavailable: %v\n", err)
+			}
+		}
 		return nil
 	}
 }
 
+// trackContainer registers a running container's cgroup with the cost tracker.
+// Accounting is best effort: without the CPU collector or cgroup v2 the job simply runs untracked.
+func trackContainer(ctx context.Context, cli *client.Client, containerID, job string, started time.Time) (uint64, bool) {
+	info, err := cli.ContainerInspect(ctx, containerID)
+	if err != nil || info.State == nil || info.State.Pid == 0 {
+		logDebug("[DOCKER] Cannot resolve PID of %s, CPU cost not tracked\n", containerID[:DockerShortIDLength])
+		return 0, false
+	}
+	cgroupID, err := containerCgroupID(info.State.Pid)
+	if err != nil {
+		logDebug("[DOCKER] CPU cost not tracked: %v\n", err)
+		return 0, false
+	}
+	if err := localContainers.start(cgroupID, containerID, job, started); err != nil {
+		logDebug("[DOCKER] CPU cost not tracked: %v\n", err)
+		return 0, false
+	}
+	return cgroupID, true
+}
+
 // CHANGE 3: forwardJobToPeer blocks and returns the actual node IP
 func forwardJobToPeer(ip string, job *pb.JobRequest) (string, error) {
 	logDebug("[SCHEDULER] Forwarding Job %s to %s (Waiting)...\n", job.Id, ip)
-	target := ip + ":" + PeerPort
 
 	// Long timeout to allow execution
 	ctx, cancel := context.WithTimeout(context.Background(), JobForwardTimeout)
 	defer cancel()
 
-	conn, err := grpc.DialContext(ctx, target, grpc.WithInsecure(), grpc.WithBlock())
+	client, err := peerConns.client(ip)
 	if err != nil {
 		return "", fmt.Errorf("dial fail: %v", err)
 	}
-	defer conn.Close()
-
-	client := pb.NewMetricsServiceClient(conn)
 
 	// This call will now hang until the remote peer finishes the Docker task
 	resp, err := client.SubmitJob(ctx, job)
@@ -264,19 +481,41 @@ type peerServer struct {
 	pb.UnimplementedMetricsServiceServer
 }
 
-func (s *peerServer) Push(ctx context.Context, m *pb.MetricsSnapshot) (*pb.Ack, error) {
+// senderIP returns the IP of the peer that made an RPC.
+func senderIP(ctx context.Context) string {
 	p, ok := peer.FromContext(ctx)
-	senderIP := "unknown"
 	if ok {
 		host, _, err := net.SplitHostPort(p.Addr.String())
 		if err == nil {
-			senderIP = host
+			return host
 		}
 	}
-	globalCluster.Update(senderIP, m)
+	return "unknown"
+}
+
+func (s *peerServer) Push(ctx context.Context, m *pb.MetricsSnapshot) (*pb.Ack, error) {
+	// Unary calls can arrive out of order, so Push is always version ordered.
+	if err := globalCluster.Apply(senderIP(ctx), m, false); err != nil {
+		logDebug("[GOSSIP] Push from %s: dropped version %d: %v", senderIP(ctx), m.Version, err)
+	}
 	return &pb.Ack{Msg: "OK"}, nil
 }
 
+// Gossip serves a stream a peer opened to us; our own snapshots flow back over it.
+func (s *peerServer) Gossip(stream pb.MetricsService_GossipServer) error {
+	return gossip.serve(senderIP(stream.Context()), stream, true)
+}
+
+// Ping answers a SWIM probe.
+func (s *peerServer) Ping(ctx context.Context, p *pb.Probe) (*pb.ProbeAck, error) {
+	return membership.onPing(p), nil
+}
+
+// PingReq probes another member on the caller's behalf.
+func (s *peerServer) PingReq(ctx context.Context, p *pb.Probe) (*pb.ProbeAck, error) {
+	return membership.onPingReq(p), nil
+}
+
 // CHANGE 4: RPC Handler passes the return values back
 func (s *peerServer) SubmitJob(ctx context.Context, job *pb.JobRequest) (*pb.Ack, error) {
 	logDebug("\n[RPC] Received Job Request: %s\n", job.Name)
@@ -295,7 +534,7 @@ func startServer(port string) {
 		fmt.Printf("Error binding port %s: %v\n", port, err)
 		return
 	}
-	grpcServer := grpc.NewServer()
+	grpcServer := grpc.NewServer(grpc.KeepaliveEnforcementPolicy(peerKeepalivePolicy))
 	pb.RegisterMetricsServiceServer(grpcServer, &peerServer{})
 
 	go func() {
@@ -310,50 +549,32 @@ func startServer(port string) {
 // -----------------------------------------------------------------------------
 
 func runPeer(cmd *cobra.Command, args []string) {
-	startServer(PeerPort)
+	// Our address as other members know it. SWIM announces it, and epidemic
+	// gossip names the node in each state so others can relay it.
+	self := resolveAdvertiseAddr()
+	globalCluster.self = self
+	stopMembership := membership.start(self, targetPeers)
+	defer stopMembership()
 
-	// Initialize Collectors
-	cpuStream, cpuCleanup, err := StartCPUCollector()
-	if err != nil {
-		fmt.Println("CPU init failed:", err)
-		return
-	}
-	defer cpuCleanup()
+	startServer(PeerPort)
 
-	memStream, memCleanup, err := StartMEMCollector()
+	// Initialize Collectors: every registered source, sampled by one loop.
+	var localSnap LocalMetrics
+	stopCollectors, err := startCollectors(&localSnap, nil)
 	if err != nil {
-		fmt.Println("MEM init failed:", err)
+		fmt.Println(err)
 		return
 	}
-	defer memCleanup()
+	defer stopCollectors()
+	defer peerConns.closeAll()
 
-	tempStream, tempCleanup, err := StartTEMPCollector()
-	if err != nil {
-		fmt.Println("TEMP init failed:", err)
-		return
+	if gossipFanout > 0 {
+		logDebug("Epidemic gossip: fanout %d, advertising %q", gossipFanout, self)
 	}
-	defer tempCleanup()
-
-	var localSnap MetricsSnapshot
 
-	go func() {
-		for v := range cpuStream {
-			localSnap.UpdateCPU(v)
-		}
-	}()
-	go func() {
-		for v := range memStream {
-			localSnap.UpdateMem(v)
-		}
-	}()
-	go func() {
-		for v := range tempStream {
-			localSnap.UpdateTemp(v)
-		}
-	}()
-
-	ticker := time.NewTicker(3 * time.Second)
+	ticker := time.NewTicker(GossipInterval)
 	defer ticker.Stop()
+	var encoder gossipEncoder
 
 	stop := make(chan os.Signal, 1)
 	signal.Notify(stop, syscall.SIGINT, syscall.SIGTERM)
@@ -370,10 +591,37 @@ func runPeer(cmd *cobra.Command, args []string) {
 				TempC:      current.TempC,
 				TempStatus: current.TempStatus,
 				Zone:       current.ZoneName,
+				Zones:      toProtoZones(current.Zones),
+				SecsToWarm: current.SecsToWarm,
+				MemStallMs: current.MemStallMs,
+				OomKills:   uint32(current.OOMKills),
+				RunqP50Us:  current.RunqP50Us,
+				RunqP99Us:  current.RunqP99Us,
+				CoreBusy:   toProtoCores(current.CoreBusy),
+				IdleCores:  uint32(current.IdleCores),
+				EffCpu:     current.EffCPU,
+				FreqRatio:  current.FreqRatio,
+				Cores:      uint32(currentCPUCapacity()),
+			}
+			if gossipFanout > 0 {
+				protoData.Node = self
+			}
+			if current.PSI != nil {
+				protoData.CpuPressure = toProtoPressure(current.PSI.CPU)
+				protoData.MemPressure = toProtoPressure(current.PSI.Memory)
+				protoData.IoPressure = toProtoPressure(current.PSI.IO)
 			}
 
 			globalCluster.Update("localhost", protoData)
-			broadcastMetrics(targetPeers, protoData)
+			globalCluster.expire(time.Now())
+			// Gossip goes to every member SWIM knows of, not just the seeds.
+			update := encoder.next(protoData).withMembers(membership.piggyback())
+			peers := membership.addrs(targetPeers)
+			if gossipFanout > 0 {
+				gossipRound(peers, update)
+			} else {
+				broadcastMetrics(peers, update)
+			}
 
 			if Verbose {
 				displayCluster()
@@ -386,35 +634,85 @@ func runPeer(cmd *cobra.Command, args []string) {
 	}
 }
 
+// toProtoZones converts the local per-zone readings into their wire format.
+func toProtoZones(zones []ZoneReading) []*pb.ThermalZone {
+	out := make([]*pb.ThermalZone, 0, len(zones))
+	for _, z := range zones {
+		out = append(out, &pb.ThermalZone{Id: z.ID, Name: z.Name, TempC: z.TempC, SecsToWarm: z.SecsToWarm})
+	}
+	return out
+}
+
+// toProtoCores narrows per-core busy % to float32: whole percents are all
+// the scheduler needs, and it halves the vector on the wire.
+func toProtoCores(cores []float64) []float32 {
+	out := make([]float32, len(cores))
+	for i, c := range cores {
+		out[i] = float32(c)
+	}
+	return out
+}
+
+// toProtoPressure converts one PSI resource sample into its wire format.
+func toProtoPressure(p PressureStat) *pb.Pressure {
+	return &pb.Pressure{
+		SomeAvg10:   p.SomeAvg10,
+		FullAvg10:   p.FullAvg10,
+		SomeTotalUs: p.SomeTotalUs,
+		FullTotalUs: p.FullTotalUs,
+	}
+}
+
 // -----------------------------------------------------------------------------
 // Client / Gossip Logic (Egress)
 // -----------------------------------------------------------------------------
 
-func broadcastMetrics(peers []string, data *pb.MetricsSnapshot) {
-	if len(peers) == 0 {
-		return
+// broadcastMetrics sends the update over every open gossip stream, then
+// pushes the full state to each listed peer that has none yet. Their streams are dialed
+// in the background and carry the next tick.
+func broadcastMetrics(peers []string, update *gossipUpdate) {
+	streaming := !gossipPush && !dialPerPush
+	var reached map[string]bool
+	if streaming {
+		reached = gossip.broadcast(update)
 	}
 	for _, ip := range peers {
-		if strings.TrimSpace(ip) == "" {
+		if strings.TrimSpace(ip) == "" || reached[ip] {
 			continue
 		}
-		go sendToPeer(ip, data)
+		if streaming {
+			gossip.open(ip)
+		}
+		go sendToPeer(ip, update.full)
 	}
 }
 
 func sendToPeer(ip string, data *pb.MetricsSnapshot) {
-	target := ip + ":60000"
 	ctx, cancel := context.WithTimeout(context.Background(), 2*time.Second)
 	defer cancel()
 
-	conn, err := grpc.DialContext(ctx, target, grpc.WithInsecure(), grpc.WithBlock())
+	start := time.Now()
+	var err error
+	if dialPerPush {
+		err = pushOverNewConn(ctx, ip, data)
+	} else {
+		var client pb.MetricsServiceClient
+		if client, err = peerConns.client(ip); err == nil {
+			_, err = client.Push(ctx, data)
+		}
+	}
+	logDebug("[GOSSIP] push %s: %.3f ms (err: %v)", ip, float64(time.Since(start).Microseconds())/1000, err)
+}
+
+// pushOverNewConn is the pre-pool push: dial, wait for the connection, push, close.
+func pushOverNewConn(ctx context.Context, ip string, data *pb.MetricsSnapshot) error {
+	conn, err := grpc.NewClient(ip+":"+PeerPort, peerDialOptions()...)
 	if err != nil {
-		return
+		return err
 	}
 	defer conn.Close()
-
-	client := pb.NewMetricsServiceClient(conn)
-	_, _ = client.Push(ctx, data)
+	_, err = pb.NewMetricsServiceClient(conn).Push(ctx, data, grpc.WaitForReady(true))
+	return err
 }
 
 // -----------------------------------------------------------------------------
@@ -423,6 +721,7 @@ func sendToPeer(ip string, data *pb.MetricsSnapshot) {
 
 func displayCluster() {
 	view := globalCluster.Snapshot()
+	live := globalCluster.liveNodes()
 
 	// Clear screen
 	fmt.Print("\033[H\033[2J")
@@ -448,8 +747,10 @@ func displayCluster() {
 		// 1. Calculate Age & Online Status
 		age := time.Since(data.LastSeen)
 		var statusStr string
+		state, member := membership.state(ip)
+		suspect := member && state == memberSuspect
 
-		if age > NodeTTL {
+		if !nodeLive(ip, data, live) && !suspect {
 			// Node is stale/offline
 			statusStr = fmt.Sprintf("\033[31mOFFLINE\033[0m (%.0fs)", age.Seconds())
 
@@ -459,8 +760,11 @@ func displayCluster() {
 			continue
 		}
 
-		// Node is Online
+		// Node is Online (or suspected dead by SWIM, pending refutation)
 		statusStr = "\033[32mONLINE\033[0m"
+		if suspect {
+			statusStr = "\033[33mSUSPECT\033[0m"
+		}
 
 		// 2. Format Temperature
 		// If TempStatus is empty, it means the collector never sent data (eBPF inactive/no sensor)
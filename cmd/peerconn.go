@@ -0,0 +1,123 @@
+package cmd
+
+import (
+	"sync"
+	"time"
+
+	"google.golang.org/grpc"
+	"google.golang.org/grpc/backoff"
+	"google.golang.org/grpc/credentials/insecure"
+	"google.golang.org/grpc/keepalive"
+
+	pb "ebpf_edge/proto"
+)
+
+// -----------------------------------------------------------------------------
+// Peer Connection Pool
+// -----------------------------------------------------------------------------
+//
+// Every RPC to a peer (metric pushes, forwarded jobs) goes over one long-lived
+// ClientConn per peer. Dialing per push cost a TCP handshake plus HTTP/2 setup
+// every 3 seconds per peer and left a TIME_WAIT socket behind each time.
+// A ClientConn reconnects by itself with backoff when the peer goes away, so
+// entries are never evicted; the pool only grows with the member list.
+
+const (
+	// PeerKeepaliveTime is how long a connection may sit idle before the client pings.
+	// Pushes every 3s normally keep it busy; the ping detects a dead peer between them.
+	PeerKeepaliveTime = 10 * time.Second
+
+	// PeerKeepaliveTimeout is how long a ping may go unanswered before the connection is dropped.
+	PeerKeepaliveTimeout = 3 * time.Second
+
+	// PeerReconnectMaxDelay caps the backoff between reconnect attempts to a peer that is down.
+	PeerReconnectMaxDelay = 10 * time.Second
+
+	// PeerIdleTimeout is how long a connection may go without RPCs before it is closed.
+	// An idle connection reconnects on its next RPC.
+	PeerIdleTimeout = 30 * time.Second
+)
+
+// dialPerPush restores one connection per push, to measure what the pool saves.
+var dialPerPush bool
+
+func init() {
+	peerCmd.Flags().BoolVar(&dialPerPush, "dial-per-push", false, "Dial a new connection for every metrics push (benchmark baseline)")
+}
+
+// peerDialOptions are shared by pooled and per-push connections.
+func peerDialOptions() []grpc.DialOption {
+	return []grpc.DialOption{
+		grpc.WithTransportCredentials(insecure.NewCredentials()),
+		grpc.WithKeepaliveParams(keepalive.ClientParameters{
+			Time:                PeerKeepaliveTime,
+			Timeout:             PeerKeepaliveTimeout,
+			PermitWithoutStream: true,
+		}),
+		grpc.WithConnectParams(grpc.ConnectParams{
+			Backoff: backoff.Config{
+				BaseDelay:  500 * time.Millisecond,
+				Multiplier: 1.6,
+				Jitter:     0.2,
+				MaxDelay:   PeerReconnectMaxDelay,
+			},
+			MinConnectTimeout: 2 * time.Second,
+		}),
+		// Epidemic gossip reaches a random few members per round: a connection
+		// not used for a while is closed instead of kept alive by pings.
+		grpc.WithIdleTimeout(PeerIdleTimeout),
+	}
+}
+
+// peerKeepalivePolicy lets clients ping as often as PeerKeepaliveTime.
+// The server default (one ping per 5 minutes) would answer with GOAWAY.
+var peerKeepalivePolicy = keepalive.EnforcementPolicy{
+	MinTime:             PeerKeepaliveTime / 2,
+	PermitWithoutStream: true,
+}
+
+// peerConnPool maps peer IPs to their long-lived connections.
+type peerConnPool struct {
+	mu    sync.Mutex
+	conns map[string]*grpc.ClientConn
+}
+
+var peerConns = peerConnPool{
+	conns: make(map[string]*grpc.ClientConn),
+}
+
+// get returns the connection to ip, creating it on first use.
+// grpc.NewClient does not block: the first RPC triggers the connect, and an
+// RPC to a peer that is down fails immediately instead of waiting for a dial.
+func (p *peerConnPool) get(ip string) (*grpc.ClientConn, error) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	if conn, ok := p.conns[ip]; ok {
+		return conn, nil
+	}
+	conn, err := grpc.NewClient(ip+":"+PeerPort, peerDialOptions()...)
+	if err != nil {
+		return nil, err
+	}
+	p.conns[ip] = conn
+	return conn, nil
+}
+
+// client returns a MetricsService client over the pooled connection to ip.
+func (p *peerConnPool) client(ip string) (pb.MetricsServiceClient, error) {
+	conn, err := p.get(ip)
+	if err != nil {
+		return nil, err
+	}
+	return pb.NewMetricsServiceClient(conn), nil
+}
+
+// closeAll closes every pooled connection.
+func (p *peerConnPool) closeAll() {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	for ip, conn := range p.conns {
+		conn.Close()
+		delete(p.conns, ip)
+	}
+}
@@ -0,0 +1,87 @@
+package cmd
+
+import "runtime/metrics"
+
+// pidHistory remembers each PID's cumulative runtime from the previous poll.
+// Entries are tagged with the generation (poll) that last saw them, so PIDs
+// that left the BPF map without an exit event (LRU eviction, dropped exits)
+// are pruned after one poll instead of accumulating for the agent's lifetime.
+type pidHistory struct {
+	gen  uint32
+	last map[uint32]pidSample
+	peak int // Largest size since the map was last rebuilt
+}
+
+type pidSample struct {
+	ns  uint64
+	gen uint32
+}
+
+// pidHistoryMinRebuild keeps small maps from being rebuilt over and over.
+const pidHistoryMinRebuild = 1024
+
+func newPIDHistory() *pidHistory {
+	return &pidHistory{last: make(map[uint32]pidSample)}
+}
+
+// begin starts a new poll generation.
+func (h *pidHistory) begin() {
+	h.gen++
+}
+
+// observe records a PID seen in this generation and returns its previous runtime.
+func (h *pidHistory) observe(pid uint32, ns uint64) uint64 {
+	prev := h.last[pid].ns
+	h.last[pid] = pidSample{ns: ns, gen: h.gen}
+	return prev
+}
+
+// take removes a PID and returns its last recorded runtime.
+func (h *pidHistory) take(pid uint32) uint64 {
+	prev := h.last[pid].ns
+	delete(h.last, pid)
+	return prev
+}
+
+func (h *pidHistory) len() int {
+	return len(h.last)
+}
+
+// prune drops every PID the current generation did not see and returns how many.
+// Go maps never release their buckets, so after a churn spike leaves the map
+// much smaller than its peak, the survivors are copied into a fresh map.
+func (h *pidHistory) prune() int {
+	removed := 0
+	for pid, s := range h.last {
+		if s.gen != h.gen {
+			delete(h.last, pid)
+			removed++
+		}
+	}
+
+	n := len(h.last)
+	if n > h.peak {
+		h.peak = n
+	}
+	if h.peak >= pidHistoryMinRebuild && n < h.peak/4 {
+		fresh := make(map[uint32]pidSample, n)
+		for pid, s := range h.last {
+			fresh[pid] = s
+		}
+		h.last = fresh
+		h.peak = n
+	}
+	return removed
+}
+
+// heapSample is reused so reading the metric does not allocate.
+var heapSample = []metrics.Sample{{Name: "/memory/classes/heap/objects:bytes"}}
+
+// heapBytes returns the bytes occupied by live and not-yet-swept heap objects.
+func heapBytes() uint64 {
+	metrics.Read(heapSample)
+	if heapSample[0].Value.Kind() != metrics.KindUint64 {
+		return 0
+	}
+	return heapSample[0].Value.Uint64()
+}
@@ -0,0 +1,117 @@
+package cmd
+
+import (
+	"syscall"
+)
+
+// procFile keeps a /proc (or /sys) file open and rereads it in place.
+// Every read is a single pread at offset 0 into a reusable buffer, so steady
+// state polling performs no open/close syscalls and no heap allocations.
+type procFile struct {
+	path string
+	fd   int
+	buf  []byte
+}
+
+func openProcFile(path string, size int) (*procFile, error) {
+	fd, err := syscall.Open(path, syscall.O_RDONLY|syscall.O_CLOEXEC, 0)
+	if err != nil {
+		return nil, err
+	}
+	return &procFile{path: path, fd: fd, buf: make([]byte, size)}, nil
+}
+
+// read returns the current file contents. The slice aliases the internal
+// buffer and is only valid until the next call.
+func (p *procFile) read() ([]byte, error) {
+	for {
+		n, err := syscall.Pread(p.fd, p.buf, 0)
+		if err != nil {
+			return nil, err
+		}
+		// A full buffer may mean truncation: grow once and reread.
+		if n < len(p.buf) {
+			return p.buf[:n], nil
+		}
+		p.buf = make([]byte, 2*len(p.buf))
+	}
+}
+
+func (p *procFile) Close() error {
+	return syscall.Close(p.fd)
+}
+
+// parseUint reads the decimal number starting at the first digit in b.
+// It returns the value and the remainder of b after the number.
+func parseUint(b []byte) (uint64, []byte, bool) {
+	i := 0
+	for i < len(b) && (b[i] < '0' || b[i] > '9') {
+		if b[i] == '\n' {
+			return 0, b[i:], false
+		}
+		i++
+	}
+	if i == len(b) {
+		return 0, nil, false
+	}
+	var v uint64
+	for i < len(b) && b[i] >= '0' && b[i] <= '9' {
+		v = v*10 + uint64(b[i]-'0')
+		i++
+	}
+	return v, b[i:], true
+}
+
+// nextLine splits b at the first newline.
+func nextLine(b []byte) (line, rest []byte) {
+	for i, c := range b {
+		if c == '\n' {
+			return b[:i], b[i+1:]
+		}
+	}
+	return b, nil
+}
+
+// hasPrefix is bytes.HasPrefix for a string prefix without converting it.
+func hasPrefix(b []byte, prefix string) bool {
+	if len(b) < len(prefix) {
+		return false
+	}
+	for i := 0; i < len(prefix); i++ {
+		if b[i] != prefix[i] {
+			return false
+		}
+	}
+	return true
+}
+
+// parseDecimal reads a number like "12.34" starting at the first digit in b.
+// The kernel prints PSI averages as fixed-point with two decimals; any number
+// of fraction digits is accepted.
+func parseDecimal(b []byte) (float64, []byte, bool) {
+	whole, rest, ok := parseUint(b)
+	if !ok {
+		return 0, rest, false
+	}
+	v := float64(whole)
+	if len(rest) > 0 && rest[0] == '.' {
+		rest = rest[1:]
+		scale := 0.1
+		for len(rest) > 0 && rest[0] >= '0' && rest[0] <= '9' {
+			v += float64(rest[0]-'0') * scale
+			scale /= 10
+			rest = rest[1:]
+		}
+	}
+	return v, rest, true
+}
+
+// fieldValue returns the text after "key" in line, e.g. fieldValue(line, "total=").
+func fieldValue(line []byte, key string) ([]byte, bool) {
+	for i := 0; i+len(key) <= len(line); i++ {
+		if hasPrefix(line[i:], key) {
+			return line[i+len(key):], true
+		}
+	}
+	return nil, false
+}
@@ -0,0 +1,102 @@
+package cmd
+
+import (
+	"testing"
+)
+
+func TestParseUint(t *testing.T) {
+	tests := []struct {
+		name string
+		in   string
+		want uint64
+		rest string
+		ok   bool
+	}{
+		{"meminfo value", "       16318304 kB", 16318304, " kB", true},
+		{"leading digit", "42", 42, "", true},
+		{"stops at non-digit", "12ab", 12, "ab", true},
+		{"zero", "  0\n", 0, "\n", true},
+		{"max uint64", "18446744073709551615", 18446744073709551615, "", true},
+		{"empty", "", 0, "", false},
+		{"no digits", "  kB", 0, "", false},
+		{"newline before digits", "  \n123", 0, "\n123", false},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			got, rest, ok := parseUint([]byte(tt.in))
+			if got != tt.want || string(rest) != tt.rest || ok != tt.ok {
+				t.Errorf("parseUint(%q) = %d, %q, %v; want %d, %q, %v", tt.in, got, rest, ok, tt.want, tt.rest, tt.ok)
+			}
+		})
+	}
+}
+
+func TestParseDecimal(t *testing.T) {
+	tests := []struct {
+		name string
+		in   string
+		want float64
+		rest string
+		ok   bool
+	}{
+		{"psi average", "12.34 avg60=", 12.34, " avg60=", true},
+		{"first digit wins", "avg10=12.34", 10, "=12.34", true}, // Callers cut at the key with fieldValue first
+		{"integer", "7 ", 7, " ", true},
+		{"zero", "0.00", 0, "", true},
+		{"one fraction digit", "3.5x", 3.5, "x", true},
+		{"trailing dot", "9.", 9, "", true},
+		{"no digits", "avg=", 0, "", false},
+		{"newline first", "\n1.5", 0, "\n1.5", false},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			got, rest, ok := parseDecimal([]byte(tt.in))
+			if diff := got - tt.want; diff > 1e-9 || diff < -1e-9 || string(rest) != tt.rest || ok != tt.ok {
+				t.Errorf("parseDecimal(%q) = %g, %q, %v; want %g, %q, %v", tt.in, got, rest, ok, tt.want, tt.rest, tt.ok)
+			}
+		})
+	}
+}
+
+func TestNextLine(t *testing.T) {
+	tests := []struct {
+		in, line, rest string
+		restNil        bool
+	}{
+		{"a\nb\n", "a", "b\n", false},
+		{"a\n", "a", "", false},
+		{"\nb", "", "b", false},
+		{"no newline", "no newline", "", true},
+		{"", "", "", true},
+	}
+	for _, tt := range tests {
+		line, rest := nextLine([]byte(tt.in))
+		if string(line) != tt.line || string(rest) != tt.rest || (rest == nil) != tt.restNil {
+			t.Errorf("nextLine(%q) = %q, %q; want %q, %q (nil %v)", tt.in, line, rest, tt.line, tt.rest, tt.restNil)
+		}
+	}
+}
+
+func TestFieldValue(t *testing.T) {
+	line := "some avg10=1.50 avg60=0.75 avg300=0.10 total=123456"
+	tests := []struct {
+		key  string
+		want string
+		ok   bool
+	}{
+		{"avg10=", "1.50 avg60=0.75 avg300=0.10 total=123456", true},
+		{"avg60=", "0.75 avg300=0.10 total=123456", true},
+		{"total=", "123456", true},
+		{"some", " avg10=1.50 avg60=0.75 avg300=0.10 total=123456", true},
+		{"avg30=", "", false},
+		{"avg30", "0=0.10 total=123456", true}, // Matches inside avg300: callers include the '='
+		{"full", "", false},
+		{"total=123456 ", "", false},
+	}
+	for _, tt := range tests {
+		got, ok := fieldValue([]byte(line), tt.key)
+		if string(got) != tt.want || ok != tt.ok {
+			t.Errorf("fieldValue(%q) = %q, %v; want %q, %v", tt.key, got, ok, tt.want, tt.ok)
+		}
+	}
+}
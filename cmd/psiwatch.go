@@ -0,0 +1,172 @@
+package cmd
+
+import (
+	"fmt"
+	"log"
+	"os"
+	"os/signal"
+	"syscall"
+	"time"
+
+	"github.com/spf13/cobra"
+)
+
+// --- CLI Command Setup ---
+var psiwatchCmd = &cobra.Command{
+	Use:   "psiwatch",
+	Short: "Collect CPU/memory/IO stall time via /proc/pressure (PSI)",
+	Run:   runPSIWatch,
+}
+
+func init() {
+	rootCmd.AddCommand(psiwatchCmd)
+	// PSI is optional: kernels built without CONFIG_PSI (or booted with psi=0) lack /proc/pressure.
+	registerCollector("PSI", true, openPSICollector)
+}
+
+// PressureStat is one /proc/pressure/<resource> sample.
+// "some" is the share of wall time in which at least one task stalled on the
+// resource; "full" is the share in which every non-idle task stalled at once.
+type PressureStat struct {
+	SomeAvg10   float64 // % of the last 10s with at least one task stalled
+	FullAvg10   float64 // % of the last 10s with all tasks stalled
+	SomeTotalUs uint64  // Cumulative "some" stall time in µs since boot
+	FullTotalUs uint64  // Cumulative "full" stall time in µs since boot
+}
+
+// PSIReading is one sample of all three pressure files.
+type PSIReading struct {
+	CPU    PressureStat
+	Memory PressureStat
+	IO     PressureStat
+}
+
+// psiReader keeps the pressure files open and parses them without allocating.
+type psiReader struct {
+	cpu, memory, io *procFile
+}
+
+func openPSI() (*psiReader, error) {
+	// Each file is two ~60 byte lines.
+	var files [3]*procFile
+	for i, name := range []string{"cpu", "memory", "io"} {
+		f, err := openProcFile("/proc/pressure/"+name, 256)
+		if err != nil {
+			for _, opened := range files[:i] {
+				opened.Close()
+			}
+			return nil, err
+		}
+		files[i] = f
+	}
+	return &psiReader{cpu: files[0], memory: files[1], io: files[2]}, nil
+}
+
+func (r *psiReader) Close() {
+	r.cpu.Close()
+	r.memory.Close()
+	r.io.Close()
+}
+
+func (r *psiReader) read() (PSIReading, error) {
+	var out PSIReading
+	var err error
+	if out.CPU, err = readPressure(r.cpu); err != nil {
+		return out, err
+	}
+	if out.Memory, err = readPressure(r.memory); err != nil {
+		return out, err
+	}
+	if out.IO, err = readPressure(r.io); err != nil {
+		return out, err
+	}
+	return out, nil
+}
+
+// readPressure parses one pressure file:
+//
+//	some avg10=0.12 avg60=0.05 avg300=0.01 total=123456
+//	full avg10=0.00 avg60=0.00 avg300=0.00 total=7890
+//
+// Kernels before 5.13 print no "full" line for cpu; those fields stay zero.
+func readPressure(f *procFile) (PressureStat, error) {
+	var s PressureStat
+	buf, err := f.read()
+	if err != nil {
+		return s, err
+	}
+
+	for rest := buf; len(rest) > 0; {
+		var line []byte
+		line, rest = nextLine(rest)
+
+		var avg *float64
+		var total *uint64
+		switch {
+		case hasPrefix(line, "some "):
+			avg, total = &s.SomeAvg10, &s.SomeTotalUs
+		case hasPrefix(line, "full "):
+			avg, total = &s.FullAvg10, &s.FullTotalUs
+		default:
+			continue
+		}
+
+		v, ok := fieldValue(line, "avg10=")
+		if !ok {
+			return s, fmt.Errorf("%s: missing avg10", f.path)
+		}
+		*avg, _, _ = parseDecimal(v)
+
+		v, ok = fieldValue(line, "total=")
+		if !ok {
+			return s, fmt.Errorf("%s: missing total", f.path)
+		}
+		*total, _, _ = parseUint(v)
+	}
+	return s, nil
+}
+
+// psiPollInterval is how often the sampling loop reads /proc/pressure.
+// The kernel already averages the stall shares, so polling loses nothing between samples.
+const psiPollInterval = 1 * time.Second
+
+// --- The Collector ---
+// openPSICollector fails if the kernel was built without CONFIG_PSI or booted with psi=0.
+func openPSICollector(wake func()) (Collector, error) {
+	psi, err := openPSI()
+	if err != nil {
+		return nil, fmt.Errorf("open /proc/pressure (CONFIG_PSI required): %v", err)
+	}
+	return psi, nil
+}
+
+func (r *psiReader) Interval() time.Duration { return psiPollInterval }
+
+func (r *psiReader) Sample(now time.Time, m *LocalMetrics) error {
+	v, err := r.read()
+	if err != nil {
+		return err
+	}
+	m.UpdatePSI(v)
+	return nil
+}
+
+// --- Run Handler ---
+func runPSIWatch(cmd *cobra.Command, args []string) {
+	var local LocalMetrics
+	cleanup, err := startCollectors(&local, func() {
+		if v := local.Read().PSI; v != nil {
+			logDebug("PSI avg10 | CPU some: %.2f%% | MEM some/full: %.2f%%/%.2f%% | IO some/full: %.2f%%/%.2f%%\n",
+				v.CPU.SomeAvg10, v.Memory.SomeAvg10, v.Memory.FullAvg10, v.IO.SomeAvg10, v.IO.FullAvg10)
+		}
+	}, "PSI")
+	if err != nil {
+		log.Fatalf("Init error: %v", err)
+	}
+	defer cleanup()
+
+	logDebug("Collecting PSI... CTRL+C to stop")
+	stop := make(chan os.Signal, 1)
+	signal.Notify(stop, syscall.SIGINT, syscall.SIGTERM)
+	<-stop
+}
@@ -59,6 +59,10 @@ func runJob(cmd *cobra.Command, args []string) {
 			// Args: Spawn 2 CPU stressors for 30 seconds
 			Args: []string{"--cpu", "2", "--timeout", "30s"},
 			Id:   uuid.New().String(),
+			// CPU-bound: judge nodes by their CPU zone, not e.g. the GPU
+			ThermalZone:       "cpu",
+			ExpectedDurationS: 30,
+			Threads:           2,
 		}
 
 	case "DATA_ETL":
@@ -70,8 +74,10 @@ func runJob(cmd *cobra.Command, args []string) {
 			ReqMem: 30.0,
 			Image:  "alexeiled/stress-ng",
 			// Args: Spawn 2 VM workers consuming 128MB each for 30 seconds
-			Args: []string{"--vm", "2", "--vm-bytes", "128M", "--timeout", "30s"},
-			Id:   uuid.New().String(),
+			Args:              []string{"--vm", "2", "--vm-bytes", "128M", "--timeout", "30s"},
+			Id:                uuid.New().String(),
+			ExpectedDurationS: 30,
+			Threads:           2,
 		}
 
 	case "MATRIX_OPS":
@@ -83,8 +89,12 @@ func runJob(cmd *cobra.Command, args []string) {
 			ReqMem: 15.0,
 			Image:  "alexeiled/stress-ng",
 			// Args: Spawn 1 Matrix stressor to simulate dense computation
-			Args: []string{"--matrix", "1", "--timeout", "30s"},
-			Id:   uuid.New().String(),
+			Args:              []string{"--matrix", "1", "--timeout", "30s"},
+			Id:                uuid.New().String(),
+			ThermalZone:       "cpu",
+			ExpectedDurationS: 30,
+			// One stressor: a single busy thread that wants a core to itself
+			Threads: 1,
 		}
 
 	default:
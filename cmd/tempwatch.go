@@ -1,16 +1,23 @@
 package cmd
 
 import (
+	"bytes"
+	"encoding/binary"
+	"errors"
 	"fmt"
 	"log"
+	"math"
 	"os"
 	"os/signal"
+	"sort"
 	"strings"
+	"sync"
 	"syscall"
 	"time"
 
 	"github.com/cilium/ebpf"
 	"github.com/cilium/ebpf/link"
+	"github.com/cilium/ebpf/ringbuf"
 	"github.com/cilium/ebpf/rlimit"
 	"github.com/spf13/cobra"
 )
@@ -23,59 +30,141 @@ var tempwatchCmd = &cobra.Command{
 
 func init() {
 	rootCmd.AddCommand(tempwatchCmd)
+	rootCmd.PersistentFlags().Float64Var(&thermalDeltaC, "temp-delta", 0.5, "Minimum temperature change (°C) pushed from the kernel")
+	registerCollector("TEMP", false, openTEMPCollector)
 }
 
 // Generate BOTH binaries
 //go:generate go run github.com/cilium/ebpf/cmd/bpf2go thermal_core ../bpf/thermal_core.c -- -O2 -target bpf -I/usr/include/x86_64-linux-gnu
 //go:generate go run github.com/cilium/ebpf/cmd/bpf2go thermal_tegra ../bpf/thermal_tegra.c -- -O2 -target bpf -I/usr/include/x86_64-linux-gnu
 
+// Thermal classification thresholds. They also become the in-kernel trip
+// points, so crossing one is always reported even below the delta.
+const (
+	thermalWarmC = 60.0
+	thermalHotC  = 80.0
+)
+
+// thermalDeltaC is the minimum temperature change the kernel reports to us.
+var thermalDeltaC float64
+
+// TempReading describes the node's thermal state.
+// TempC/Status/Zone summarize the hottest zone; Zones carries every zone.
 type TempReading struct {
-	TempC  float64
-	Status string
-	Zone   string
+	TempC      float64
+	Status     string
+	Zone       string
+	Zones      []ZoneReading
+	SecsToWarm float64 // Predicted seconds until any zone crosses WARM (0 = not heading there)
+}
+
+// ZoneReading is the latest reading of a single thermal zone.
+type ZoneReading struct {
+	ID         uint32
+	Name       string
+	TempC      float64
+	Updated    time.Time
+	SecsToWarm float64 // Slope-based time-to-WARM estimate (0 = none predicted)
+}
+
+// thermalEvent mirrors 'struct thermal_event' in bpf/thermal_*.c.
+type thermalEvent struct {
+	ID     uint32
+	TempMC int32 // Signed: the kernel reports sub-zero and invalid zones as negative
+	PrevMC int32
+	_      uint32
+	TsNS   uint64
+	Zone   [16]byte
 }
 
 // thermalBPF abstracts the specific eBPF objects (Tegra vs Core)
 type thermalBPF struct {
-	prog     *ebpf.Program
-	mapTemps *ebpf.Map
-	mapNames *ebpf.Map
-	mapCount *ebpf.Map
-	cleanup  func()
+	prog    *ebpf.Program
+	events  *ebpf.Map
+	cleanup func()
+}
+
+// configureThermalSpec writes the userspace thresholds into the object's
+// read-only globals before the verifier sees it.
+func configureThermalSpec(spec *ebpf.CollectionSpec) error {
+	// A negative delta would wrap around in the u32 cast and silence every event.
+	if thermalDeltaC < 0 || thermalDeltaC*1000 > math.MaxUint32 {
+		return fmt.Errorf("--temp-delta out of range: %g", thermalDeltaC)
+	}
+	consts := map[string]uint32{
+		"temp_delta_mc": uint32(thermalDeltaC * 1000),
+		"warm_trip_mc":  uint32(thermalWarmC * 1000),
+		"hot_trip_mc":   uint32(thermalHotC * 1000),
+	}
+	for name, v := range consts {
+		variable, ok := spec.Variables[name]
+		if !ok {
+			return fmt.Errorf("missing variable %s", name)
+		}
+		if err := variable.Set(v); err != nil {
+			return fmt.Errorf("set %s: %v", name, err)
+		}
+	}
+	return nil
 }
 
 func loadTegraBPF() (*thermalBPF, error) {
+	spec, err := loadThermal_tegra()
+	if err != nil {
+		return nil, fmt.Errorf("load tegra temp spec: %v", err)
+	}
+	if err := configureThermalSpec(spec); err != nil {
+		return nil, fmt.Errorf("configure tegra temp: %v", err)
+	}
 	var objs thermal_tegraObjects
-	if err := loadThermal_tegraObjects(&objs, nil); err != nil {
+	if err := spec.LoadAndAssign(&objs, nil); err != nil {
 		return nil, fmt.Errorf("load tegra temp: %v", err)
 	}
 	return &thermalBPF{
-		prog:     objs.HandleThermalTemp,
-		mapTemps: objs.ZoneTemps,
-		mapNames: objs.ZoneNames,
-		mapCount: objs.ZoneCount,
-		cleanup:  func() { objs.Close() },
+		prog:    objs.HandleThermalTemp,
+		events:  objs.ThermalEvents,
+		cleanup: func() { objs.Close() },
 	}, nil
 }
 
 func loadCoreBPF() (*thermalBPF, error) {
+	spec, err := loadThermal_core()
+	if err != nil {
+		return nil, fmt.Errorf("load core temp spec: %v", err)
+	}
+	if err := configureThermalSpec(spec); err != nil {
+		return nil, fmt.Errorf("configure core temp: %v", err)
+	}
 	var objs thermal_coreObjects
-	if err := loadThermal_coreObjects(&objs, nil); err != nil {
+	if err := spec.LoadAndAssign(&objs, nil); err != nil {
 		return nil, fmt.Errorf("load core temp: %v", err)
 	}
 	return &thermalBPF{
-		prog:     objs.HandleThermalTemp,
-		mapTemps: objs.ZoneTemps,
-		mapNames: objs.ZoneNames,
-		mapCount: objs.ZoneCount,
-		cleanup:  func() { objs.Close() },
+		prog:    objs.HandleThermalTemp,
+		events:  objs.ThermalEvents,
+		cleanup: func() { objs.Close() },
 	}, nil
 }
 
-func StartTEMPCollector() (<-chan TempReading, func(), error) {
+// tempCollector owns the thermal program and the per-zone state built from its events.
+type tempCollector struct {
+	bpf *thermalBPF
+	tp  link.Link
+	rd  *ringbuf.Reader
+
+	mu      sync.Mutex
+	arrived []ZoneReading // Decoded by watch, applied by the next Sample
+
+	zones     map[uint32]ZoneReading // Latest reading per zone id, so each sample publishes the full vector
+	trends    map[uint32]*zoneTrend
+	published bool
+	heating   bool // The last reading predicted a WARM crossing
+}
+
+func openTEMPCollector(wake func()) (Collector, error) {
 
 	if err := rlimit.RemoveMemlock(); err != nil {
-		return nil, nil, fmt.Errorf("rlimit error: %v", err)
+		return nil, fmt.Errorf("rlimit error: %v", err)
 	}
 
 	// 1. Detect Kernel
@@ -92,71 +181,157 @@ func StartTEMPCollector() (<-chan TempReading, func(), error) {
 
 	bpf, err := loader()
 	if err != nil {
-		return nil, nil, err
+		return nil, err
 	}
 
 	// 3. Attach Tracepoint
 	tp, err := link.Tracepoint("thermal", "thermal_temperature", bpf.prog, nil)
 	if err != nil {
 		bpf.cleanup()
-		return nil, nil, fmt.Errorf("attach temp tracepoint: %v", err)
+		return nil, fmt.Errorf("attach temp tracepoint: %v", err)
 	}
 
-	finalCleanup := func() {
+	// 4. Open the Event Stream
+	rd, err := ringbuf.NewReader(bpf.events)
+	if err != nil {
 		tp.Close()
 		bpf.cleanup()
+		return nil, fmt.Errorf("open thermal ringbuf: %v", err)
 	}
 
-	out := make(chan TempReading)
-
-	go pollThermalStats(out, bpf)
-
-	return out, finalCleanup, nil
+	c := &tempCollector{
+		bpf:    bpf,
+		tp:     tp,
+		rd:     rd,
+		zones:  make(map[uint32]ZoneReading),
+		trends: make(map[uint32]*zoneTrend),
+	}
+	go c.watch(wake)
+	return c, nil
 }
 
-func pollThermalStats(out chan<- TempReading, bpf *thermalBPF) {
-	defer close(out)
-	ticker := time.NewTicker(1 * time.Second)
-	defer ticker.Stop()
+// Interval is the prediction refresh period: between kernel events only a
+// heating zone's time-to-WARM changes.
+func (c *tempCollector) Interval() time.Duration { return trendRefresh }
 
-	for range ticker.C {
-		var key uint32 = 0
-		var tempMC uint32
-		var zoneCount uint32
-		var namebuf [16]byte
+func (c *tempCollector) Close() {
+	// Closing the reader unblocks watch.
+	c.rd.Close()
+	c.tp.Close()
+	c.bpf.cleanup()
+}
 
-		// CRITICAL SECTION: Read BPF Maps for Thermal Data
-		// 1. Check if the BPF program has actually detected a thermal zone (count > 0).
-		if err := bpf.mapCount.Lookup(&key, &zoneCount); err != nil || zoneCount == 0 {
-			continue
+// watch blocks on the ring buffer and hands each kernel event to the sampling
+// loop, waking it so changes reach the snapshot within milliseconds instead of
+// on the next tick. Nothing runs while the temperature is stable.
+func (c *tempCollector) watch(wake func()) {
+	var rec ringbuf.Record
+	for {
+		err := c.rd.ReadInto(&rec)
+		if errors.Is(err, ringbuf.ErrClosed) {
+			return
 		}
-		// 2. Retrieve the latest temperature reading (in millidegrees Celsius).
-		if err := bpf.mapTemps.Lookup(&key, &tempMC); err != nil {
+		if err != nil {
+			logDebug("thermal ringbuf read: %v", err)
 			continue
 		}
-		// 3. Retrieve the zone name (e.g., "CPU-therm").
-		if err := bpf.mapNames.Lookup(&key, &namebuf); err != nil {
+		var ev thermalEvent
+		if err := binary.Read(bytes.NewReader(rec.RawSample), binary.NativeEndian, &ev); err != nil {
 			continue
 		}
+		z := ZoneReading{
+			ID:   ev.ID,
+			Name: strings.Trim(string(ev.Zone[:]), "\x00"),
+			// Convert millidegrees to degrees Celsius.
+			TempC:   float64(ev.TempMC) / 1000.0,
+			Updated: time.Now(),
+		}
+		c.mu.Lock()
+		c.arrived = append(c.arrived, z)
+		c.mu.Unlock()
+		wake()
+	}
+}
+
+// Sample applies the events that arrived since the last sample and publishes
+// the zone summary. With no new event and no zone heating up, the published
+// reading is still current and nothing is done.
+func (c *tempCollector) Sample(now time.Time, m *LocalMetrics) error {
+	c.mu.Lock()
+	arrived := c.arrived
+	c.arrived = nil
+	c.mu.Unlock()
+
+	if len(arrived) == 0 && c.published && !c.heating {
+		return nil
+	}
+	for _, z := range arrived {
+		c.zones[z.ID] = z
+		trend, ok := c.trends[z.ID]
+		if !ok {
+			trend = &zoneTrend{}
+			c.trends[z.ID] = trend
+		}
+		trend.add(z.Updated, z.TempC)
+	}
+	// Nothing to report until the kernel has pushed a first reading.
+	if len(c.zones) == 0 {
+		return nil
+	}
 
-		zone := strings.Trim(string(namebuf[:]), "\x00")
-		// Convert millidegrees to degrees Celsius.
-		tempC := float64(tempMC) / 1000.0
+	r := summarizeZones(c.zones, c.trends, now)
+	c.heating = r.SecsToWarm > 0
+	c.published = true
+	m.UpdateTemp(r)
+	return nil
+}
 
-		// Determine status based on hardcoded safety thresholds.
-		status := "SAFE"
-		if tempC > 80.0 {
-			status = "HOT"
-		} else if tempC > 60.0 {
-			status = "WARM"
+// summarizeZones builds a TempReading from every known zone, sorted by id.
+// The headline temperature and status come from the hottest zone, and the
+// prediction from the zone expected to cross WARM first.
+func summarizeZones(zones map[uint32]ZoneReading, trends map[uint32]*zoneTrend, now time.Time) TempReading {
+	var r TempReading
+	r.Zones = make([]ZoneReading, 0, len(zones))
+	for id, z := range zones {
+		if trend, ok := trends[id]; ok {
+			z.SecsToWarm = secsToWarm(z.TempC, trend.slope(now))
 		}
+		r.Zones = append(r.Zones, z)
+	}
+	sort.Slice(r.Zones, func(i, j int) bool { return r.Zones[i].ID < r.Zones[j].ID })
 
-		out <- TempReading{TempC: tempC, Status: status, Zone: zone}
+	for i, z := range r.Zones {
+		if i == 0 || z.TempC > r.TempC {
+			r.TempC = z.TempC
+			r.Zone = z.Name
+		}
+		if z.SecsToWarm > 0 && (r.SecsToWarm == 0 || z.SecsToWarm < r.SecsToWarm) {
+			r.SecsToWarm = z.SecsToWarm
+		}
 	}
+	r.Status = classifyTemp(r.TempC)
+	return r
+}
+
+// classifyTemp maps a temperature to SAFE/WARM/HOT using the safety thresholds.
+func classifyTemp(tempC float64) string {
+	if tempC > thermalHotC {
+		return "HOT"
+	} else if tempC > thermalWarmC {
+		return "WARM"
+	}
+	return "SAFE"
 }
 
 func runTempWatch(cmd *cobra.Command, args []string) {
-	stream, cleanup, err := StartTEMPCollector()
+	var local LocalMetrics
+	cleanup, err := startCollectors(&local, func() {
+		v := local.Read()
+		logDebug("[%s] %.1f°C (%s) warm in %.0fs\n", v.ZoneName, v.TempC, v.TempStatus, v.SecsToWarm)
+		for _, z := range v.Zones {
+			logDebug("    zone %2d %-16s %.1f°C", z.ID, z.Name, z.TempC)
+		}
+	}, "TEMP")
 	if err != nil {
 		log.Fatal(err)
 	}
@@ -164,12 +339,5 @@ func runTempWatch(cmd *cobra.Command, args []string) {
 	logDebug("Collecting Thermal... CTRL+C to stop")
 	stop := make(chan os.Signal, 1)
 	signal.Notify(stop, syscall.SIGINT, syscall.SIGTERM)
-	for {
-		select {
-		case v := <-stream:
-			logDebug("[%s] %.1f°C (%s)\n", v.Zone, v.TempC, v.Status)
-		case <-stop:
-			return
-		}
-	}
+	<-stop
 }
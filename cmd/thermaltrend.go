@@ -0,0 +1,82 @@
+package cmd
+
+import "time"
+
+// Trend estimation parameters.
+// The kernel only reports meaningful changes, so a handful of samples over a
+// minute is enough to see a node heating up under load.
+const (
+	trendSamples  = 16               // Readings kept per zone
+	trendWindow   = 60 * time.Second // Older readings no longer describe the current load
+	trendMinSlope = 0.01             // °C/s; slower drifts are treated as stable
+	trendRefresh  = 1 * time.Second  // Re-evaluation period while a zone is heating
+)
+
+type trendSample struct {
+	at    time.Time
+	tempC float64
+}
+
+// zoneTrend keeps a short ring of readings for one thermal zone and
+// estimates how fast it is heating up.
+type zoneTrend struct {
+	samples [trendSamples]trendSample
+	head    int // Next slot to write
+	n       int // Valid samples
+}
+
+func (t *zoneTrend) add(at time.Time, tempC float64) {
+	t.samples[t.head] = trendSample{at: at, tempC: tempC}
+	t.head = (t.head + 1) % trendSamples
+	if t.n < trendSamples {
+		t.n++
+	}
+}
+
+// slope returns the least-squares heating rate in °C/s over the recent window.
+// The latest reading is also counted as still valid at 'now': the kernel stays
+// silent while the temperature is within the delta, so a quiet zone is a
+// stable zone and its old slope decays instead of going stale.
+func (t *zoneTrend) slope(now time.Time) float64 {
+	if t.n == 0 {
+		return 0
+	}
+	var sumX, sumY, sumXX, sumXY float64
+	count := 0.0
+	accumulate := func(s trendSample) {
+		x := s.at.Sub(now).Seconds()
+		sumX += x
+		sumY += s.tempC
+		sumXX += x * x
+		sumXY += x * s.tempC
+		count++
+	}
+
+	var latest trendSample
+	for i := 0; i < t.n; i++ {
+		s := t.samples[(t.head-1-i+trendSamples)%trendSamples]
+		if i == 0 {
+			latest = s
+		}
+		if now.Sub(s.at) > trendWindow {
+			break
+		}
+		accumulate(s)
+	}
+	accumulate(trendSample{at: now, tempC: latest.tempC})
+
+	denom := count*sumXX - sumX*sumX
+	if count < 2 || denom == 0 {
+		return 0
+	}
+	return (count*sumXY - sumX*sumY) / denom
+}
+
+// secsToWarm predicts how long until a zone at tempC crosses WARM.
+// Zero means no crossing is predicted (cooling, stable, or already WARM).
+func secsToWarm(tempC, slope float64) float64 {
+	if tempC >= thermalWarmC || slope < trendMinSlope {
+		return 0
+	}
+	return (thermalWarmC - tempC) / slope
+}
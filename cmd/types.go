@@ -1,7 +1,7 @@
 package cmd
 
 import (
-	"sync"
+	"sync/atomic"
 	"syscall"
 )
 
@@ -20,56 +20,94 @@ func detectKernel() string {
 
 // MetricsSnapshot holds the latest metrics captured from all local collectors.
 // It is the standard data format exchanged between collectors and the main app.
+// A MetricsSnapshot is a plain value: LocalMetrics.Read assembles one per call.
 type MetricsSnapshot struct {
-	CPUPercent float64 // Aggregated + clamped CPU usage
-	MemPercent float64 // Direct memory pressure reading
-	TempC      float64 // Temperature in Celsius
-	TempStatus string  // SAFE/WARM/HOT/UNAVAILABLE
-	ZoneName   string  // Thermal zone name
+	CPUPercent float64   // Aggregated + clamped CPU usage
+	RunqP50Us  float64   // Median wakeup-to-run delay (µs)
+	RunqP99Us  float64   // 99th percentile wakeup-to-run delay (µs)
+	CoreBusy   []float64 // Busy % per CPU
+	EffCPU     float64   // CPU usage scaled by clock/max clock, clamped like CPUPercent
+	FreqRatio  float64   // Busy-time weighted clock/max clock (0 = no cpufreq)
+	IdleCores  int       // CPUs with room for a single-threaded job
+	MemPercent float64   // Direct memory pressure reading
+	MemStallMs float64   // Direct-reclaim stall per second (0 without --mem-ebpf)
+	OOMKills   uint64    // OOM kills within the last memOOMWindow
+	TempC      float64   // Temperature in Celsius
+	TempStatus string    // SAFE/WARM/HOT/UNAVAILABLE
+	ZoneName   string    // Thermal zone name (hottest zone)
+	Zones      []ZoneReading
+	SecsToWarm float64     // Predicted seconds until WARM (0 = not heating towards it)
+	PSI        *PSIReading // Pressure stall information (nil when unavailable)
 
-	// mu protects the snapshot from concurrent writes by collectors
-	// and reads by the gRPC sender/display loop.
-	mu sync.RWMutex
+	// The agent's own footprint, sampled by the CPU collector.
+	TrackedPIDs int    // PIDs the CPU poller remembers between polls (--cpu-per-pid)
+	HeapBytes   uint64 // Live and not-yet-swept heap objects of the agent
 }
 
-// UpdateCPU updates the CPU metric with a hard clamp at 95%.
+// LocalMetrics is the live, shared copy of the local collectors' latest readings.
+// Each collector publishes an immutable reading through an atomic pointer swap,
+// so writers never wait for readers and readers never wait at all. Fields that
+// arrive together (e.g. a CPU sample's percent and per-core vector) stay
+// together: a reader sees either the whole previous sample or the whole new one.
+type LocalMetrics struct {
+	cpu  atomic.Pointer[CPUReading]
+	mem  atomic.Pointer[MemReading]
+	temp atomic.Pointer[TempReading]
+	psi  atomic.Pointer[PSIReading]
+}
+
+// UpdateCPU updates the CPU metrics with a hard clamp at 95% on utilization.
 // We clamp because kernel calculations can sometimes spike or drift slightly above 100%
 // in containerized or virtualized environments.
-func (m *MetricsSnapshot) UpdateCPU(v float64) {
-	if v > 95 {
-		v = 95
-	}
-	m.mu.Lock()
-	m.CPUPercent = v
-	m.mu.Unlock()
+func (m *LocalMetrics) UpdateCPU(r CPUReading) {
+	r.Percent = min(r.Percent, 95)
+	r.Effective = min(r.Effective, 95)
+	m.cpu.Store(&r)
 }
 
-// UpdateMem updates the memory usage percentage.
-func (m *MetricsSnapshot) UpdateMem(v float64) {
-	m.mu.Lock()
-	m.MemPercent = v
-	m.mu.Unlock()
+// UpdateMem updates the memory usage percentage and pressure counters.
+func (m *LocalMetrics) UpdateMem(r MemReading) {
+	m.mem.Store(&r)
 }
 
 // UpdateTemp updates the temperature data from the sensor reading.
-func (m *MetricsSnapshot) UpdateTemp(r TempReading) {
-	m.mu.Lock()
-	m.TempC = r.TempC
-	m.TempStatus = r.Status
-	m.ZoneName = r.Zone
-	m.mu.Unlock()
+func (m *LocalMetrics) UpdateTemp(r TempReading) {
+	m.temp.Store(&r)
 }
 
-// Read returns a copy of the snapshot for safe access by other goroutines.
-// This ensures the display loop doesn't read half-written data.
-func (m *MetricsSnapshot) Read() MetricsSnapshot {
-	m.mu.RLock()
-	defer m.mu.RUnlock()
-	return MetricsSnapshot{
-		CPUPercent: m.CPUPercent,
-		MemPercent: m.MemPercent,
-		TempC:      m.TempC,
-		TempStatus: m.TempStatus,
-		ZoneName:   m.ZoneName,
+// UpdatePSI updates the pressure stall information.
+func (m *LocalMetrics) UpdatePSI(r PSIReading) {
+	m.psi.Store(&r)
+}
+
+// Read returns the latest snapshot without locking or allocating.
+// Published readings are never mutated, so the returned value can share their
+// strings and slices (Zones, CoreBusy) with them.
+func (m *LocalMetrics) Read() MetricsSnapshot {
+	var snap MetricsSnapshot
+	if c := m.cpu.Load(); c != nil {
+		snap.CPUPercent = c.Percent
+		snap.RunqP50Us = c.RunqP50Us
+		snap.RunqP99Us = c.RunqP99Us
+		snap.CoreBusy = c.CoreBusy
+		snap.IdleCores = c.IdleCores
+		snap.EffCPU = c.Effective
+		snap.FreqRatio = c.FreqRatio
+		snap.TrackedPIDs = c.TrackedPIDs
+		snap.HeapBytes = c.HeapBytes
+	}
+	if r := m.mem.Load(); r != nil {
+		snap.MemPercent = r.Percent
+		snap.MemStallMs = r.StallMs
+		snap.OOMKills = r.OOMKills
+	}
+	if t := m.temp.Load(); t != nil {
+		snap.TempC = t.TempC
+		snap.TempStatus = t.Status
+		snap.ZoneName = t.Zone
+		snap.Zones = t.Zones
+		snap.SecsToWarm = t.SecsToWarm
 	}
+	snap.PSI = m.psi.Load()
+	return snap
 }
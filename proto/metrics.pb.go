@@ -21,21 +21,245 @@ const (
 	_ = protoimpl.EnforceVersion(protoimpl.MaxVersion - 20)
 )
 
-type MetricsSnapshot struct {
+// ThermalZone is the latest reading of one kernel thermal zone
+type ThermalZone struct {
 	state         protoimpl.MessageState `protogen:"open.v1"`
-	Cpu           float64                `protobuf:"fixed64,1,opt,name=cpu,proto3" json:"cpu,omitempty"`
-	Mem           float64                `protobuf:"fixed64,2,opt,name=mem,proto3" json:"mem,omitempty"`
+	Id            uint32                 `protobuf:"varint,1,opt,name=id,proto3" json:"id,omitempty"`    // Tracepoint zone id
+	Name          string                 `protobuf:"bytes,2,opt,name=name,proto3" json:"name,omitempty"` // e.g. "CPU-therm", "GPU-therm", "tj-therm"
 	TempC         float64                `protobuf:"fixed64,3,opt,name=temp_c,json=tempC,proto3" json:"temp_c,omitempty"`
-	TempStatus    string                 `protobuf:"bytes,4,opt,name=temp_status,json=tempStatus,proto3" json:"temp_status,omitempty"`
-	Zone          string                 `protobuf:"bytes,5,opt,name=zone,proto3" json:"zone,omitempty"`
-	Hardware      string                 `protobuf:"bytes,6,opt,name=hardware,proto3" json:"hardware,omitempty"`
+	SecsToWarm    float64                `protobuf:"fixed64,4,opt,name=secs_to_warm,json=secsToWarm,proto3" json:"secs_to_warm,omitempty"` // Predicted seconds until this zone crosses WARM; 0 = not heating towards it
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *ThermalZone) Reset() {
+	*x = ThermalZone{}
+	mi := &file_proto_metrics_proto_msgTypes[0]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *ThermalZone) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*ThermalZone) ProtoMessage() {}
+
+func (x *ThermalZone) ProtoReflect() protoreflect.Message {
+	mi := &file_proto_metrics_proto_msgTypes[0]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use ThermalZone.ProtoReflect.Descriptor instead.
+func (*ThermalZone) Descriptor() ([]byte, []int) {
+	return file_proto_metrics_proto_rawDescGZIP(), []int{0}
+}
+
+func (x *ThermalZone) GetId() uint32 {
+	if x != nil {
+		return x.Id
+	}
+	return 0
+}
+
+func (x *ThermalZone) GetName() string {
+	if x != nil {
+		return x.Name
+	}
+	return ""
+}
+
+func (x *ThermalZone) GetTempC() float64 {
+	if x != nil {
+		return x.TempC
+	}
+	return 0
+}
+
+func (x *ThermalZone) GetSecsToWarm() float64 {
+	if x != nil {
+		return x.SecsToWarm
+	}
+	return 0
+}
+
+// Pressure is one /proc/pressure/<resource> sample (PSI)
+type Pressure struct {
+	state         protoimpl.MessageState `protogen:"open.v1"`
+	SomeAvg10     float64                `protobuf:"fixed64,1,opt,name=some_avg10,json=someAvg10,proto3" json:"some_avg10,omitempty"`        // % of the last 10s with at least one task stalled
+	FullAvg10     float64                `protobuf:"fixed64,2,opt,name=full_avg10,json=fullAvg10,proto3" json:"full_avg10,omitempty"`        // % of the last 10s with all non-idle tasks stalled
+	SomeTotalUs   uint64                 `protobuf:"varint,3,opt,name=some_total_us,json=someTotalUs,proto3" json:"some_total_us,omitempty"` // Cumulative stall time since boot
+	FullTotalUs   uint64                 `protobuf:"varint,4,opt,name=full_total_us,json=fullTotalUs,proto3" json:"full_total_us,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *Pressure) Reset() {
+	*x = Pressure{}
+	mi := &file_proto_metrics_proto_msgTypes[1]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *Pressure) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*Pressure) ProtoMessage() {}
+
+func (x *Pressure) ProtoReflect() protoreflect.Message {
+	mi := &file_proto_metrics_proto_msgTypes[1]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use Pressure.ProtoReflect.Descriptor instead.
+func (*Pressure) Descriptor() ([]byte, []int) {
+	return file_proto_metrics_proto_rawDescGZIP(), []int{1}
+}
+
+func (x *Pressure) GetSomeAvg10() float64 {
+	if x != nil {
+		return x.SomeAvg10
+	}
+	return 0
+}
+
+func (x *Pressure) GetFullAvg10() float64 {
+	if x != nil {
+		return x.FullAvg10
+	}
+	return 0
+}
+
+func (x *Pressure) GetSomeTotalUs() uint64 {
+	if x != nil {
+		return x.SomeTotalUs
+	}
+	return 0
+}
+
+func (x *Pressure) GetFullTotalUs() uint64 {
+	if x != nil {
+		return x.FullTotalUs
+	}
+	return 0
+}
+
+// Member is one node's membership record (SWIM). Only the node itself bumps
+// its incarnation, to refute a suspicion; a higher incarnation overrides any older record.
+type Member struct {
+	state         protoimpl.MessageState `protogen:"open.v1"`
+	Addr          string                 `protobuf:"bytes,1,opt,name=addr,proto3" json:"addr,omitempty"`
+	Incarnation   uint64                 `protobuf:"varint,2,opt,name=incarnation,proto3" json:"incarnation,omitempty"`
+	State         uint32                 `protobuf:"varint,3,opt,name=state,proto3" json:"state,omitempty"` // 0 = alive, 1 = suspect, 2 = dead
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *Member) Reset() {
+	*x = Member{}
+	mi := &file_proto_metrics_proto_msgTypes[2]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *Member) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*Member) ProtoMessage() {}
+
+func (x *Member) ProtoReflect() protoreflect.Message {
+	mi := &file_proto_metrics_proto_msgTypes[2]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use Member.ProtoReflect.Descriptor instead.
+func (*Member) Descriptor() ([]byte, []int) {
+	return file_proto_metrics_proto_rawDescGZIP(), []int{2}
+}
+
+func (x *Member) GetAddr() string {
+	if x != nil {
+		return x.Addr
+	}
+	return ""
+}
+
+func (x *Member) GetIncarnation() uint64 {
+	if x != nil {
+		return x.Incarnation
+	}
+	return 0
+}
+
+func (x *Member) GetState() uint32 {
+	if x != nil {
+		return x.State
+	}
+	return 0
+}
+
+type MetricsSnapshot struct {
+	state       protoimpl.MessageState `protogen:"open.v1"`
+	Cpu         float64                `protobuf:"fixed64,1,opt,name=cpu,proto3" json:"cpu,omitempty"`
+	Mem         float64                `protobuf:"fixed64,2,opt,name=mem,proto3" json:"mem,omitempty"`
+	TempC       float64                `protobuf:"fixed64,3,opt,name=temp_c,json=tempC,proto3" json:"temp_c,omitempty"`
+	TempStatus  string                 `protobuf:"bytes,4,opt,name=temp_status,json=tempStatus,proto3" json:"temp_status,omitempty"`
+	Zone        string                 `protobuf:"bytes,5,opt,name=zone,proto3" json:"zone,omitempty"`
+	Hardware    string                 `protobuf:"bytes,6,opt,name=hardware,proto3" json:"hardware,omitempty"`
+	Zones       []*ThermalZone         `protobuf:"bytes,7,rep,name=zones,proto3" json:"zones,omitempty"`                                 // Every zone; temp_c/zone above describe the hottest
+	SecsToWarm  float64                `protobuf:"fixed64,8,opt,name=secs_to_warm,json=secsToWarm,proto3" json:"secs_to_warm,omitempty"` // Predicted seconds until WARM; 0 = not heating towards it
+	MemStallMs  float64                `protobuf:"fixed64,9,opt,name=mem_stall_ms,json=memStallMs,proto3" json:"mem_stall_ms,omitempty"` // Direct-reclaim stall per second (eBPF memory probes)
+	OomKills    uint32                 `protobuf:"varint,10,opt,name=oom_kills,json=oomKills,proto3" json:"oom_kills,omitempty"`         // OOM victims in the last 30s
+	CpuPressure *Pressure              `protobuf:"bytes,11,opt,name=cpu_pressure,json=cpuPressure,proto3" json:"cpu_pressure,omitempty"` // Unset when the kernel has no PSI
+	MemPressure *Pressure              `protobuf:"bytes,12,opt,name=mem_pressure,json=memPressure,proto3" json:"mem_pressure,omitempty"`
+	IoPressure  *Pressure              `protobuf:"bytes,13,opt,name=io_pressure,json=ioPressure,proto3" json:"io_pressure,omitempty"`
+	RunqP50Us   float64                `protobuf:"fixed64,14,opt,name=runq_p50_us,json=runqP50Us,proto3" json:"runq_p50_us,omitempty"` // Wakeup-to-run delay percentiles over the last CPU poll
+	RunqP99Us   float64                `protobuf:"fixed64,15,opt,name=runq_p99_us,json=runqP99Us,proto3" json:"runq_p99_us,omitempty"`
+	CoreBusy    []float32              `protobuf:"fixed32,16,rep,packed,name=core_busy,json=coreBusy,proto3" json:"core_busy,omitempty"` // Busy % per CPU over the last poll
+	IdleCores   uint32                 `protobuf:"varint,17,opt,name=idle_cores,json=idleCores,proto3" json:"idle_cores,omitempty"`      // CPUs under 10% busy
+	EffCpu      float64                `protobuf:"fixed64,18,opt,name=eff_cpu,json=effCpu,proto3" json:"eff_cpu,omitempty"`              // cpu scaled by clock/max clock: capacity actually consumed
+	FreqRatio   float64                `protobuf:"fixed64,19,opt,name=freq_ratio,json=freqRatio,proto3" json:"freq_ratio,omitempty"`     // Busy-time weighted clock/max clock; 0 = no cpufreq
+	// Change suppression: fields 1-19 and 28 are only resent when they move past a deadband.
+	Version     uint64 `protobuf:"varint,20,opt,name=version,proto3" json:"version,omitempty"`                            // Sender's state version; bumps when any field is resent
+	BaseVersion uint64 `protobuf:"varint,21,opt,name=base_version,json=baseVersion,proto3" json:"base_version,omitempty"` // Delta against this version: only 'changed' fields are set; 0 = full
+	Changed     uint64 `protobuf:"varint,22,opt,name=changed,proto3" json:"changed,omitempty"`                            // Delta only: bit n set = field n is carried
+	Heartbeat   bool   `protobuf:"varint,23,opt,name=heartbeat,proto3" json:"heartbeat,omitempty"`                        // No fields: the state at 'version' is still current
+	// Epidemic gossip: a node's state reaches nodes it never talks to directly.
+	Node          string             `protobuf:"bytes,24,opt,name=node,proto3" json:"node,omitempty"`                 // Address of the node this state describes
+	AgeMs         uint32             `protobuf:"varint,25,opt,name=age_ms,json=ageMs,proto3" json:"age_ms,omitempty"` // Relayed states only: how long ago the relayer last heard of 'node'
+	Relayed       []*MetricsSnapshot `protobuf:"bytes,26,rep,name=relayed,proto3" json:"relayed,omitempty"`           // Recent third-party states (full, not nested), bounded per message
+	Members       []*Member          `protobuf:"bytes,27,rep,name=members,proto3" json:"members,omitempty"`           // Piggybacked membership updates (SWIM dissemination)
+	Cores         uint32             `protobuf:"varint,28,opt,name=cores,proto3" json:"cores,omitempty"`              // Online CPUs: cpu is a share of these, and job costs in cores convert by them
 	unknownFields protoimpl.UnknownFields
 	sizeCache     protoimpl.SizeCache
 }
 
 func (x *MetricsSnapshot) Reset() {
 	*x = MetricsSnapshot{}
-	mi := &file_proto_metrics_proto_msgTypes[0]
+	mi := &file_proto_metrics_proto_msgTypes[3]
 	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
 	ms.StoreMessageInfo(mi)
 }
@@ -47,7 +271,7 @@ func (x *MetricsSnapshot) String() string {
 func (*MetricsSnapshot) ProtoMessage() {}
 
 func (x *MetricsSnapshot) ProtoReflect() protoreflect.Message {
-	mi := &file_proto_metrics_proto_msgTypes[0]
+	mi := &file_proto_metrics_proto_msgTypes[3]
 	if x != nil {
 		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
 		if ms.LoadMessageInfo() == nil {
@@ -60,7 +284,7 @@ func (x *MetricsSnapshot) ProtoReflect() protoreflect.Message {
 
 // Deprecated: Use MetricsSnapshot.ProtoReflect.Descriptor instead.
 func (*MetricsSnapshot) Descriptor() ([]byte, []int) {
-	return file_proto_metrics_proto_rawDescGZIP(), []int{0}
+	return file_proto_metrics_proto_rawDescGZIP(), []int{3}
 }
 
 func (x *MetricsSnapshot) GetCpu() float64 {
@@ -105,6 +329,160 @@ func (x *MetricsSnapshot) GetHardware() string {
 	return ""
 }
 
+func (x *MetricsSnapshot) GetZones() []*ThermalZone {
+	if x != nil {
+		return x.Zones
+	}
+	return nil
+}
+
+func (x *MetricsSnapshot) GetSecsToWarm() float64 {
+	if x != nil {
+		return x.SecsToWarm
+	}
+	return 0
+}
+
+func (x *MetricsSnapshot) GetMemStallMs() float64 {
+	if x != nil {
+		return x.MemStallMs
+	}
+	return 0
+}
+
+func (x *MetricsSnapshot) GetOomKills() uint32 {
+	if x != nil {
+		return x.OomKills
+	}
+	return 0
+}
+
+func (x *MetricsSnapshot) GetCpuPressure() *Pressure {
+	if x != nil {
+		return x.CpuPressure
+	}
+	return nil
+}
+
+func (x *MetricsSnapshot) GetMemPressure() *Pressure {
+	if x != nil {
+		return x.MemPressure
+	}
+	return nil
+}
+
+func (x *MetricsSnapshot) GetIoPressure() *Pressure {
+	if x != nil {
+		return x.IoPressure
+	}
+	return nil
+}
+
+func (x *MetricsSnapshot) GetRunqP50Us() float64 {
+	if x != nil {
+		return x.RunqP50Us
+	}
+	return 0
+}
+
+func (x *MetricsSnapshot) GetRunqP99Us() float64 {
+	if x != nil {
+		return x.RunqP99Us
+	}
+	return 0
+}
+
+func (x *MetricsSnapshot) GetCoreBusy() []float32 {
+	if x != nil {
+		return x.CoreBusy
+	}
+	return nil
+}
+
+func (x *MetricsSnapshot) GetIdleCores() uint32 {
+	if x != nil {
+		return x.IdleCores
+	}
+	return 0
+}
+
+func (x *MetricsSnapshot) GetEffCpu() float64 {
+	if x != nil {
+		return x.EffCpu
+	}
+	return 0
+}
+
+func (x *MetricsSnapshot) GetFreqRatio() float64 {
+	if x != nil {
+		return x.FreqRatio
+	}
+	return 0
+}
+
+func (x *MetricsSnapshot) GetVersion() uint64 {
+	if x != nil {
+		return x.Version
+	}
+	return 0
+}
+
+func (x *MetricsSnapshot) GetBaseVersion() uint64 {
+	if x != nil {
+		return x.BaseVersion
+	}
+	return 0
+}
+
+func (x *MetricsSnapshot) GetChanged() uint64 {
+	if x != nil {
+		return x.Changed
+	}
+	return 0
+}
+
+func (x *MetricsSnapshot) GetHeartbeat() bool {
+	if x != nil {
+		return x.Heartbeat
+	}
+	return false
+}
+
+func (x *MetricsSnapshot) GetNode() string {
+	if x != nil {
+		return x.Node
+	}
+	return ""
+}
+
+func (x *MetricsSnapshot) GetAgeMs() uint32 {
+	if x != nil {
+		return x.AgeMs
+	}
+	return 0
+}
+
+func (x *MetricsSnapshot) GetRelayed() []*MetricsSnapshot {
+	if x != nil {
+		return x.Relayed
+	}
+	return nil
+}
+
+func (x *MetricsSnapshot) GetMembers() []*Member {
+	if x != nil {
+		return x.Members
+	}
+	return nil
+}
+
+func (x *MetricsSnapshot) GetCores() uint32 {
+	if x != nil {
+		return x.Cores
+	}
+	return 0
+}
+
 type Ack struct {
 	state         protoimpl.MessageState `protogen:"open.v1"`
 	Msg           string                 `protobuf:"bytes,1,opt,name=msg,proto3" json:"msg,omitempty"`
@@ -115,7 +493,7 @@ type Ack struct {
 
 func (x *Ack) Reset() {
 	*x = Ack{}
-	mi := &file_proto_metrics_proto_msgTypes[1]
+	mi := &file_proto_metrics_proto_msgTypes[4]
 	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
 	ms.StoreMessageInfo(mi)
 }
@@ -127,7 +505,7 @@ func (x *Ack) String() string {
 func (*Ack) ProtoMessage() {}
 
 func (x *Ack) ProtoReflect() protoreflect.Message {
-	mi := &file_proto_metrics_proto_msgTypes[1]
+	mi := &file_proto_metrics_proto_msgTypes[4]
 	if x != nil {
 		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
 		if ms.LoadMessageInfo() == nil {
@@ -140,7 +518,7 @@ func (x *Ack) ProtoReflect() protoreflect.Message {
 
 // Deprecated: Use Ack.ProtoReflect.Descriptor instead.
 func (*Ack) Descriptor() ([]byte, []int) {
-	return file_proto_metrics_proto_rawDescGZIP(), []int{1}
+	return file_proto_metrics_proto_rawDescGZIP(), []int{4}
 }
 
 func (x *Ack) GetMsg() string {
@@ -157,22 +535,146 @@ func (x *Ack) GetForwardedTo() string {
 	return ""
 }
 
-// JobRequest defines a workload to be executed
-type JobRequest struct {
+// Probe is a SWIM ping. Sent to PingReq, it asks the receiver to ping 'target' on the sender's behalf.
+type Probe struct {
 	state         protoimpl.MessageState `protogen:"open.v1"`
-	Name          string                 `protobuf:"bytes,1,opt,name=name,proto3" json:"name,omitempty"`                     // "IMG_RESIZE", "DATA_ETL"
-	ReqCpu        float64                `protobuf:"fixed64,2,opt,name=req_cpu,json=reqCpu,proto3" json:"req_cpu,omitempty"` // e.g. 20.0
-	ReqMem        float64                `protobuf:"fixed64,3,opt,name=req_mem,json=reqMem,proto3" json:"req_mem,omitempty"` // e.g. 10.0
-	Image         string                 `protobuf:"bytes,4,opt,name=image,proto3" json:"image,omitempty"`                   // Docker image name
-	Args          []string               `protobuf:"bytes,5,rep,name=args,proto3" json:"args,omitempty"`                     // Command arguments
-	Id            string                 `protobuf:"bytes,6,opt,name=id,proto3" json:"id,omitempty"`                         // Unique Job ID
+	From          string                 `protobuf:"bytes,1,opt,name=from,proto3" json:"from,omitempty"`       // Sender's advertised address
+	Target        string                 `protobuf:"bytes,2,opt,name=target,proto3" json:"target,omitempty"`   // PingReq only
+	Join          bool                   `protobuf:"varint,3,opt,name=join,proto3" json:"join,omitempty"`      // Sender is joining: the ack carries every member
+	Updates       []*Member              `protobuf:"bytes,4,rep,name=updates,proto3" json:"updates,omitempty"` // Piggybacked membership updates
 	unknownFields protoimpl.UnknownFields
 	sizeCache     protoimpl.SizeCache
 }
 
+func (x *Probe) Reset() {
+	*x = Probe{}
+	mi := &file_proto_metrics_proto_msgTypes[5]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *Probe) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*Probe) ProtoMessage() {}
+
+func (x *Probe) ProtoReflect() protoreflect.Message {
+	mi := &file_proto_metrics_proto_msgTypes[5]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use Probe.ProtoReflect.Descriptor instead.
+func (*Probe) Descriptor() ([]byte, []int) {
+	return file_proto_metrics_proto_rawDescGZIP(), []int{5}
+}
+
+func (x *Probe) GetFrom() string {
+	if x != nil {
+		return x.From
+	}
+	return ""
+}
+
+func (x *Probe) GetTarget() string {
+	if x != nil {
+		return x.Target
+	}
+	return ""
+}
+
+func (x *Probe) GetJoin() bool {
+	if x != nil {
+		return x.Join
+	}
+	return false
+}
+
+func (x *Probe) GetUpdates() []*Member {
+	if x != nil {
+		return x.Updates
+	}
+	return nil
+}
+
+type ProbeAck struct {
+	state         protoimpl.MessageState `protogen:"open.v1"`
+	Ok            bool                   `protobuf:"varint,1,opt,name=ok,proto3" json:"ok,omitempty"` // PingReq: whether the target answered
+	Updates       []*Member              `protobuf:"bytes,2,rep,name=updates,proto3" json:"updates,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *ProbeAck) Reset() {
+	*x = ProbeAck{}
+	mi := &file_proto_metrics_proto_msgTypes[6]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *ProbeAck) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*ProbeAck) ProtoMessage() {}
+
+func (x *ProbeAck) ProtoReflect() protoreflect.Message {
+	mi := &file_proto_metrics_proto_msgTypes[6]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use ProbeAck.ProtoReflect.Descriptor instead.
+func (*ProbeAck) Descriptor() ([]byte, []int) {
+	return file_proto_metrics_proto_rawDescGZIP(), []int{6}
+}
+
+func (x *ProbeAck) GetOk() bool {
+	if x != nil {
+		return x.Ok
+	}
+	return false
+}
+
+func (x *ProbeAck) GetUpdates() []*Member {
+	if x != nil {
+		return x.Updates
+	}
+	return nil
+}
+
+// JobRequest defines a workload to be executed
+type JobRequest struct {
+	state             protoimpl.MessageState `protogen:"open.v1"`
+	Name              string                 `protobuf:"bytes,1,opt,name=name,proto3" json:"name,omitempty"`                                                        // "IMG_RESIZE", "DATA_ETL"
+	ReqCpu            float64                `protobuf:"fixed64,2,opt,name=req_cpu,json=reqCpu,proto3" json:"req_cpu,omitempty"`                                    // e.g. 20.0
+	ReqMem            float64                `protobuf:"fixed64,3,opt,name=req_mem,json=reqMem,proto3" json:"req_mem,omitempty"`                                    // e.g. 10.0
+	Image             string                 `protobuf:"bytes,4,opt,name=image,proto3" json:"image,omitempty"`                                                      // Docker image name
+	Args              []string               `protobuf:"bytes,5,rep,name=args,proto3" json:"args,omitempty"`                                                        // Command arguments
+	Id                string                 `protobuf:"bytes,6,opt,name=id,proto3" json:"id,omitempty"`                                                            // Unique Job ID
+	ThermalZone       string                 `protobuf:"bytes,7,opt,name=thermal_zone,json=thermalZone,proto3" json:"thermal_zone,omitempty"`                       // Zone that matters for this job (substring, e.g. "cpu"); empty = hottest
+	ExpectedDurationS float64                `protobuf:"fixed64,8,opt,name=expected_duration_s,json=expectedDurationS,proto3" json:"expected_duration_s,omitempty"` // Expected runtime; nodes predicted to turn WARM sooner are avoided
+	Threads           uint32                 `protobuf:"varint,9,opt,name=threads,proto3" json:"threads,omitempty"`                                                 // Busy threads the job runs; 1 = wants an idle core, 0 = unknown
+	unknownFields     protoimpl.UnknownFields
+	sizeCache         protoimpl.SizeCache
+}
+
 func (x *JobRequest) Reset() {
 	*x = JobRequest{}
-	mi := &file_proto_metrics_proto_msgTypes[2]
+	mi := &file_proto_metrics_proto_msgTypes[7]
 	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
 	ms.StoreMessageInfo(mi)
 }
@@ -184,7 +686,7 @@ func (x *JobRequest) String() string {
 func (*JobRequest) ProtoMessage() {}
 
 func (x *JobRequest) ProtoReflect() protoreflect.Message {
-	mi := &file_proto_metrics_proto_msgTypes[2]
+	mi := &file_proto_metrics_proto_msgTypes[7]
 	if x != nil {
 		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
 		if ms.LoadMessageInfo() == nil {
@@ -197,7 +699,7 @@ func (x *JobRequest) ProtoReflect() protoreflect.Message {
 
 // Deprecated: Use JobRequest.ProtoReflect.Descriptor instead.
 func (*JobRequest) Descriptor() ([]byte, []int) {
-	return file_proto_metrics_proto_rawDescGZIP(), []int{2}
+	return file_proto_metrics_proto_rawDescGZIP(), []int{7}
 }
 
 func (x *JobRequest) GetName() string {
@@ -242,11 +744,49 @@ func (x *JobRequest) GetId() string {
 	return ""
 }
 
+func (x *JobRequest) GetThermalZone() string {
+	if x != nil {
+		return x.ThermalZone
+	}
+	return ""
+}
+
+func (x *JobRequest) GetExpectedDurationS() float64 {
+	if x != nil {
+		return x.ExpectedDurationS
+	}
+	return 0
+}
+
+func (x *JobRequest) GetThreads() uint32 {
+	if x != nil {
+		return x.Threads
+	}
+	return 0
+}
+
 var File_proto_metrics_proto protoreflect.FileDescriptor
 
 const file_proto_metrics_proto_rawDesc = "" +
 	"\n" +
-	"\x13proto/metrics.proto\x12\ametrics\"\x9d\x01\n" +
+	"\x13proto/metrics.proto\x12\ametrics\"j\n" +
+	"\vThermalZone\x12\x0e\n" +
+	"\x02id\x18\x01 \x01(\rR\x02id\x12\x12\n" +
+	"\x04name\x18\x02 \x01(\tR\x04name\x12\x15\n" +
+	"\x06temp_c\x18\x03 \x01(\x01R\x05tempC\x12 \n" +
+	"\fsecs_to_warm\x18\x04 \x01(\x01R\n" +
+	"secsToWarm\"\x90\x01\n" +
+	"\bPressure\x12\x1d\n" +
+	"\n" +
+	"some_avg10\x18\x01 \x01(\x01R\tsomeAvg10\x12\x1d\n" +
+	"\n" +
+	"full_avg10\x18\x02 \x01(\x01R\tfullAvg10\x12\"\n" +
+	"\rsome_total_us\x18\x03 \x01(\x04R\vsomeTotalUs\x12\"\n" +
+	"\rfull_total_us\x18\x04 \x01(\x04R\vfullTotalUs\"T\n" +
+	"\x06Member\x12\x12\n" +
+	"\x04addr\x18\x01 \x01(\tR\x04addr\x12 \n" +
+	"\vincarnation\x18\x02 \x01(\x04R\vincarnation\x12\x14\n" +
+	"\x05state\x18\x03 \x01(\rR\x05state\"\x93\a\n" +
 	"\x0fMetricsSnapshot\x12\x10\n" +
 	"\x03cpu\x18\x01 \x01(\x01R\x03cpu\x12\x10\n" +
 	"\x03mem\x18\x02 \x01(\x01R\x03mem\x12\x15\n" +
@@ -254,10 +794,46 @@ const file_proto_metrics_proto_rawDesc = "" +
 	"\vtemp_status\x18\x04 \x01(\tR\n" +
 	"tempStatus\x12\x12\n" +
 	"\x04zone\x18\x05 \x01(\tR\x04zone\x12\x1a\n" +
-	"\bhardware\x18\x06 \x01(\tR\bhardware\":\n" +
+	"\bhardware\x18\x06 \x01(\tR\bhardware\x12*\n" +
+	"\x05zones\x18\a \x03(\v2\x14.metrics.ThermalZoneR\x05zones\x12 \n" +
+	"\fsecs_to_warm\x18\b \x01(\x01R\n" +
+	"secsToWarm\x12 \n" +
+	"\fmem_stall_ms\x18\t \x01(\x01R\n" +
+	"memStallMs\x12\x1b\n" +
+	"\toom_kills\x18\n" +
+	" \x01(\rR\boomKills\x124\n" +
+	"\fcpu_pressure\x18\v \x01(\v2\x11.metrics.PressureR\vcpuPressure\x124\n" +
+	"\fmem_pressure\x18\f \x01(\v2\x11.metrics.PressureR\vmemPressure\x122\n" +
+	"\vio_pressure\x18\r \x01(\v2\x11.metrics.PressureR\n" +
+	"ioPressure\x12\x1e\n" +
+	"\vrunq_p50_us\x18\x0e \x01(\x01R\trunqP50Us\x12\x1e\n" +
+	"\vrunq_p99_us\x18\x0f \x01(\x01R\trunqP99Us\x12\x1b\n" +
+	"\tcore_busy\x18\x10 \x03(\x02R\bcoreBusy\x12\x1d\n" +
+	"\n" +
+	"idle_cores\x18\x11 \x01(\rR\tidleCores\x12\x17\n" +
+	"\aeff_cpu\x18\x12 \x01(\x01R\x06effCpu\x12\x1d\n" +
+	"\n" +
+	"freq_ratio\x18\x13 \x01(\x01R\tfreqRatio\x12\x18\n" +
+	"\aversion\x18\x14 \x01(\x04R\aversion\x12!\n" +
+	"\fbase_version\x18\x15 \x01(\x04R\vbaseVersion\x12\x18\n" +
+	"\achanged\x18\x16 \x01(\x04R\achanged\x12\x1c\n" +
+	"\theartbeat\x18\x17 \x01(\bR\theartbeat\x12\x12\n" +
+	"\x04node\x18\x18 \x01(\tR\x04node\x12\x15\n" +
+	"\x06age_ms\x18\x19 \x01(\rR\x05ageMs\x122\n" +
+	"\arelayed\x18\x1a \x03(\v2\x18.metrics.MetricsSnapshotR\arelayed\x12)\n" +
+	"\amembers\x18\x1b \x03(\v2\x0f.metrics.MemberR\amembers\x12\x14\n" +
+	"\x05cores\x18\x1c \x01(\rR\x05cores\":\n" +
 	"\x03Ack\x12\x10\n" +
 	"\x03msg\x18\x01 \x01(\tR\x03msg\x12!\n" +
-	"\fforwarded_to\x18\x02 \x01(\tR\vforwardedTo\"\x8c\x01\n" +
+	"\fforwarded_to\x18\x02 \x01(\tR\vforwardedTo\"r\n" +
+	"\x05Probe\x12\x12\n" +
+	"\x04from\x18\x01 \x01(\tR\x04from\x12\x16\n" +
+	"\x06target\x18\x02 \x01(\tR\x06target\x12\x12\n" +
+	"\x04join\x18\x03 \x01(\bR\x04join\x12)\n" +
+	"\aupdates\x18\x04 \x03(\v2\x0f.metrics.MemberR\aupdates\"E\n" +
+	"\bProbeAck\x12\x0e\n" +
+	"\x02ok\x18\x01 \x01(\bR\x02ok\x12)\n" +
+	"\aupdates\x18\x02 \x03(\v2\x0f.metrics.MemberR\aupdates\"\xf9\x01\n" +
 	"\n" +
 	"JobRequest\x12\x12\n" +
 	"\x04name\x18\x01 \x01(\tR\x04name\x12\x17\n" +
@@ -265,10 +841,16 @@ const file_proto_metrics_proto_rawDesc = "" +
 	"\areq_mem\x18\x03 \x01(\x01R\x06reqMem\x12\x14\n" +
 	"\x05image\x18\x04 \x01(\tR\x05image\x12\x12\n" +
 	"\x04args\x18\x05 \x03(\tR\x04args\x12\x0e\n" +
-	"\x02id\x18\x06 \x01(\tR\x02id2p\n" +
+	"\x02id\x18\x06 \x01(\tR\x02id\x12!\n" +
+	"\fthermal_zone\x18\a \x01(\tR\vthermalZone\x12.\n" +
+	"\x13expected_duration_s\x18\b \x01(\x01R\x11expectedDurationS\x12\x18\n" +
+	"\athreads\x18\t \x01(\rR\athreads2\x8b\x02\n" +
 	"\x0eMetricsService\x12.\n" +
 	"\x04Push\x12\x18.metrics.MetricsSnapshot\x1a\f.metrics.Ack\x12.\n" +
-	"\tSubmitJob\x12\x13.metrics.JobRequest\x1a\f.metrics.AckB\x19Z\x17ebpf_edge/proto;metricsb\x06proto3"
+	"\tSubmitJob\x12\x13.metrics.JobRequest\x1a\f.metrics.Ack\x12@\n" +
+	"\x06Gossip\x12\x18.metrics.MetricsSnapshot\x1a\x18.metrics.MetricsSnapshot(\x010\x01\x12)\n" +
+	"\x04Ping\x12\x0e.metrics.Probe\x1a\x11.metrics.ProbeAck\x12,\n" +
+	"\aPingReq\x12\x0e.metrics.Probe\x1a\x11.metrics.ProbeAckB\x19Z\x17ebpf_edge/proto;metricsb\x06proto3"
 
 var (
 	file_proto_metrics_proto_rawDescOnce sync.Once
@@ -282,22 +864,41 @@ func file_proto_metrics_proto_rawDescGZIP() []byte {
 	return file_proto_metrics_proto_rawDescData
 }
 
-var file_proto_metrics_proto_msgTypes = make([]protoimpl.MessageInfo, 3)
+var file_proto_metrics_proto_msgTypes = make([]protoimpl.MessageInfo, 8)
 var file_proto_metrics_proto_goTypes = []any{
-	(*MetricsSnapshot)(nil), // 0: metrics.MetricsSnapshot
-	(*Ack)(nil),             // 1: metrics.Ack
-	(*JobRequest)(nil),      // 2: metrics.JobRequest
+	(*ThermalZone)(nil),     // 0: metrics.ThermalZone
+	(*Pressure)(nil),        // 1: metrics.Pressure
+	(*Member)(nil),          // 2: metrics.Member
+	(*MetricsSnapshot)(nil), // 3: metrics.MetricsSnapshot
+	(*Ack)(nil),             // 4: metrics.Ack
+	(*Probe)(nil),           // 5: metrics.Probe
+	(*ProbeAck)(nil),        // 6: metrics.ProbeAck
+	(*JobRequest)(nil),      // 7: metrics.JobRequest
 }
 var file_proto_metrics_proto_depIdxs = []int32{
-	0, // 0: metrics.MetricsService.Push:input_type -> metrics.MetricsSnapshot
-	2, // 1: metrics.MetricsService.SubmitJob:input_type -> metrics.JobRequest
-	1, // 2: metrics.MetricsService.Push:output_type -> metrics.Ack
-	1, // 3: metrics.MetricsService.SubmitJob:output_type -> metrics.Ack
-	2, // [2:4] is the sub-list for method output_type
-	0, // [0:2] is the sub-list for method input_type
-	0, // [0:0] is the sub-list for extension type_name
-	0, // [0:0] is the sub-list for extension extendee
-	0, // [0:0] is the sub-list for field type_name
+	0,  // 0: metrics.MetricsSnapshot.zones:type_name -> metrics.ThermalZone
+	1,  // 1: metrics.MetricsSnapshot.cpu_pressure:type_name -> metrics.Pressure
+	1,  // 2: metrics.MetricsSnapshot.mem_pressure:type_name -> metrics.Pressure
+	1,  // 3: metrics.MetricsSnapshot.io_pressure:type_name -> metrics.Pressure
+	3,  // 4: metrics.MetricsSnapshot.relayed:type_name -> metrics.MetricsSnapshot
+	2,  // 5: metrics.MetricsSnapshot.members:type_name -> metrics.Member
+	2,  // 6: metrics.Probe.updates:type_name -> metrics.Member
+	2,  // 7: metrics.ProbeAck.updates:type_name -> metrics.Member
+	3,  // 8: metrics.MetricsService.Push:input_type -> metrics.MetricsSnapshot
+	7,  // 9: metrics.MetricsService.SubmitJob:input_type -> metrics.JobRequest
+	3,  // 10: metrics.MetricsService.Gossip:input_type -> metrics.MetricsSnapshot
+	5,  // 11: metrics.MetricsService.Ping:input_type -> metrics.Probe
+	5,  // 12: metrics.MetricsService.PingReq:input_type -> metrics.Probe
+	4,  // 13: metrics.MetricsService.Push:output_type -> metrics.Ack
+	4,  // 14: metrics.MetricsService.SubmitJob:output_type -> metrics.Ack
+	3,  // 15: metrics.MetricsService.Gossip:output_type -> metrics.MetricsSnapshot
+	6,  // 16: metrics.MetricsService.Ping:output_type -> metrics.ProbeAck
+	6,  // 17: metrics.MetricsService.PingReq:output_type -> metrics.ProbeAck
+	13, // [13:18] is the sub-list for method output_type
+	8,  // [8:13] is the sub-list for method input_type
+	8,  // [8:8] is the sub-list for extension type_name
+	8,  // [8:8] is the sub-list for extension extendee
+	0,  // [0:8] is the sub-list for field type_name
 }
 
 func init() { file_proto_metrics_proto_init() }
@@ -311,7 +912,7 @@ func file_proto_metrics_proto_init() {
 			GoPackagePath: reflect.TypeOf(x{}).PkgPath(),
 			RawDescriptor: unsafe.Slice(unsafe.StringData(file_proto_metrics_proto_rawDesc), len(file_proto_metrics_proto_rawDesc)),
 			NumEnums:      0,
-			NumMessages:   3,
+			NumMessages:   8,
 			NumExtensions: 0,
 			NumServices:   1,
 		},
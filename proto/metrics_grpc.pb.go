@@ -21,6 +21,9 @@ const _ = grpc.SupportPackageIsVersion9
 const (
 	MetricsService_Push_FullMethodName      = "/metrics.MetricsService/Push"
 	MetricsService_SubmitJob_FullMethodName = "/metrics.MetricsService/SubmitJob"
+	MetricsService_Gossip_FullMethodName    = "/metrics.MetricsService/Gossip"
+	MetricsService_Ping_FullMethodName      = "/metrics.MetricsService/Ping"
+	MetricsService_PingReq_FullMethodName   = "/metrics.MetricsService/PingReq"
 )
 
 // MetricsServiceClient is the client API for MetricsService service.
@@ -29,6 +32,12 @@ const (
 type MetricsServiceClient interface {
 	Push(ctx context.Context, in *MetricsSnapshot, opts ...grpc.CallOption) (*Ack, error)
 	SubmitJob(ctx context.Context, in *JobRequest, opts ...grpc.CallOption) (*Ack, error)
+	// Gossip keeps one stream open per peer pair; each side sends its snapshot every tick.
+	// Push stays as the fallback for peers that do not implement it yet.
+	Gossip(ctx context.Context, opts ...grpc.CallOption) (grpc.BidiStreamingClient[MetricsSnapshot, MetricsSnapshot], error)
+	// SWIM failure detection: a direct probe, and a probe through a helper.
+	Ping(ctx context.Context, in *Probe, opts ...grpc.CallOption) (*ProbeAck, error)
+	PingReq(ctx context.Context, in *Probe, opts ...grpc.CallOption) (*ProbeAck, error)
 }
 
 type metricsServiceClient struct {
@@ -59,12 +68,51 @@ func (c *metricsServiceClient) SubmitJob(ctx context.Context, in *JobRequest, op
 	return out, nil
 }
 
+func (c *metricsServiceClient) Gossip(ctx context.Context, opts ...grpc.CallOption) (grpc.BidiStreamingClient[MetricsSnapshot, MetricsSnapshot], error) {
+	cOpts := append([]grpc.CallOption{grpc.StaticMethod()}, opts...)
+	stream, err := c.cc.NewStream(ctx, &MetricsService_ServiceDesc.Streams[0], MetricsService_Gossip_FullMethodName, cOpts...)
+	if err != nil {
+		return nil, err
+	}
+	x := &grpc.GenericClientStream[MetricsSnapshot, MetricsSnapshot]{ClientStream: stream}
+	return x, nil
+}
+
+// This type alias is provided for backwards compatibility with existing code that references the prior non-generic stream type by name.
+type MetricsService_GossipClient = grpc.BidiStreamingClient[MetricsSnapshot, MetricsSnapshot]
+
+func (c *metricsServiceClient) Ping(ctx context.Context, in *Probe, opts ...grpc.CallOption) (*ProbeAck, error) {
+	cOpts := append([]grpc.CallOption{grpc.StaticMethod()}, opts...)
+	out := new(ProbeAck)
+	err := c.cc.Invoke(ctx, MetricsService_Ping_FullMethodName, in, out, cOpts...)
+	if err != nil {
+		return nil, err
+	}
+	return out, nil
+}
+
+func (c *metricsServiceClient) PingReq(ctx context.Context, in *Probe, opts ...grpc.CallOption) (*ProbeAck, error) {
+	cOpts := append([]grpc.CallOption{grpc.StaticMethod()}, opts...)
+	out := new(ProbeAck)
+	err := c.cc.Invoke(ctx, MetricsService_PingReq_FullMethodName, in, out, cOpts...)
+	if err != nil {
+		return nil, err
+	}
+	return out, nil
+}
+
 // MetricsServiceServer is the server API for MetricsService service.
 // All implementations must embed UnimplementedMetricsServiceServer
 // for forward compatibility.
 type MetricsServiceServer interface {
 	Push(context.Context, *MetricsSnapshot) (*Ack, error)
 	SubmitJob(context.Context, *JobRequest) (*Ack, error)
+	// Gossip keeps one stream open per peer pair; each side sends its snapshot every tick.
+	// Push stays as the fallback for peers that do not implement it yet.
+	Gossip(grpc.BidiStreamingServer[MetricsSnapshot, MetricsSnapshot]) error
+	// SWIM failure detection: a direct probe, and a probe through a helper.
+	Ping(context.Context, *Probe) (*ProbeAck, error)
+	PingReq(context.Context, *Probe) (*ProbeAck, error)
 	mustEmbedUnimplementedMetricsServiceServer()
 }
 
@@ -81,6 +129,15 @@ func (UnimplementedMetricsServiceServer) Push(context.Context, *MetricsSnapshot)
 func (UnimplementedMetricsServiceServer) SubmitJob(context.Context, *JobRequest) (*Ack, error) {
 	return nil, status.Errorf(codes.Unimplemented, "method SubmitJob not implemented")
 }
+func (UnimplementedMetricsServiceServer) Gossip(grpc.BidiStreamingServer[MetricsSnapshot, MetricsSnapshot]) error {
+	return status.Errorf(codes.Unimplemented, "method Gossip not implemented")
+}
+func (UnimplementedMetricsServiceServer) Ping(context.Context, *Probe) (*ProbeAck, error) {
+	return nil, status.Errorf(codes.Unimplemented, "method Ping not implemented")
+}
+func (UnimplementedMetricsServiceServer) PingReq(context.Context, *Probe) (*ProbeAck, error) {
+	return nil, status.Errorf(codes.Unimplemented, "method PingReq not implemented")
+}
 func (UnimplementedMetricsServiceServer) mustEmbedUnimplementedMetricsServiceServer() {}
 func (UnimplementedMetricsServiceServer) testEmbeddedByValue()                        {}
 
@@ -138,6 +195,49 @@ func _MetricsService_SubmitJob_Handler(srv interface{}, ctx context.Context, dec
 	return interceptor(ctx, in, info, handler)
 }
 
+func _MetricsService_Gossip_Handler(srv interface{}, stream grpc.ServerStream) error {
+	return srv.(MetricsServiceServer).Gossip(&grpc.GenericServerStream[MetricsSnapshot, MetricsSnapshot]{ServerStream: stream})
+}
+
+// This type alias is provided for backwards compatibility with existing code that references the prior non-generic stream type by name.
+type MetricsService_GossipServer = grpc.BidiStreamingServer[MetricsSnapshot, MetricsSnapshot]
+
+func _MetricsService_Ping_Handler(srv interface{}, ctx context.Context, dec func(interface{}) error, interceptor grpc.UnaryServerInterceptor) (interface{}, error) {
+	in := new(Probe)
+	if err := dec(in); err != nil {
+		return nil, err
+	}
+	if interceptor == nil {
+		return srv.(MetricsServiceServer).Ping(ctx, in)
+	}
+	info := &grpc.UnaryServerInfo{
+		Server:     srv,
+		FullMethod: MetricsService_Ping_FullMethodName,
+	}
+	handler := func(ctx context.Context, req interface{}) (interface{}, error) {
+		return srv.(MetricsServiceServer).Ping(ctx, req.(*Probe))
+	}
+	return interceptor(ctx, in, info, handler)
+}
+
+func _MetricsService_PingReq_Handler(srv interface{}, ctx context.Context, dec func(interface{}) error, interceptor grpc.UnaryServerInterceptor) (interface{}, error) {
+	in := new(Probe)
+	if err := dec(in); err != nil {
+		return nil, err
+	}
+	if interceptor == nil {
+		return srv.(MetricsServiceServer).PingReq(ctx, in)
+	}
+	info := &grpc.UnaryServerInfo{
+		Server:     srv,
+		FullMethod: MetricsService_PingReq_FullMethodName,
+	}
+	handler := func(ctx context.Context, req interface{}) (interface{}, error) {
+		return srv.(MetricsServiceServer).PingReq(ctx, req.(*Probe))
+	}
+	return interceptor(ctx, in, info, handler)
+}
+
 // MetricsService_ServiceDesc is the grpc.ServiceDesc for MetricsService service.
 // It's only intended for direct use with grpc.RegisterService,
 // and not to be introspected or modified (even as a copy)
@@ -153,7 +253,22 @@ var MetricsService_ServiceDesc = grpc.ServiceDesc{
 			MethodName: "SubmitJob",
 			Handler:    _MetricsService_SubmitJob_Handler,
 		},
+		{
+			MethodName: "Ping",
+			Handler:    _MetricsService_Ping_Handler,
+		},
+		{
+			MethodName: "PingReq",
+			Handler:    _MetricsService_PingReq_Handler,
+		},
+	},
+	Streams: []grpc.StreamDesc{
+		{
+			StreamName:    "Gossip",
+			Handler:       _MetricsService_Gossip_Handler,
+			ServerStreams: true,
+			ClientStreams: true,
+		},
 	},
-	Streams:  []grpc.StreamDesc{},
 	Metadata: "proto/metrics.proto",
 }